@@ -0,0 +1,60 @@
+#include <ctime>
+#include "analysis_monitor.h"
+
+// 同一阶段两次回调的最小间隔
+static const std::chrono::milliseconds REPORT_INTERVAL(100);
+
+bool AnalysisMonitor::report(const char* phase, uint64_t bytes, uint64_t totalBytes, uint64_t nodes, uint64_t edges) {
+    if (callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+        if (lastPhase != phase || now - lastReportTime >= REPORT_INTERVAL) {
+            lastPhase = phase;
+            lastReportTime = now;
+            AnalysisProgress progress;
+            progress.phase = phase;
+            progress.bytes = bytes;
+            progress.totalBytes = totalBytes;
+            progress.nodes = nodes;
+            progress.edges = edges;
+            callback(progress);
+        }
+    }
+    return !isCancelled();
+}
+
+static uint64_t threadCpuNs() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+ScopedPhase::ScopedPhase(AnalysisMonitor* monitor_, const char* phase_)
+    : monitor(monitor_), phase(phase_), cpuStart(0) {
+    if (monitor != nullptr) {
+        wallStart = std::chrono::steady_clock::now();
+        cpuStart = threadCpuNs();
+    }
+}
+
+ScopedPhase::~ScopedPhase() {
+    end();
+}
+
+void ScopedPhase::end() {
+    if (monitor != nullptr) {
+        uint64_t wallNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wallStart).count());
+        uint64_t cpuEnd = threadCpuNs();
+        monitor->getStats().addTime(phase, wallNs, cpuEnd > cpuStart ? cpuEnd - cpuStart : 0);
+        monitor = nullptr;
+    }
+}
+
+void ScopedPhase::addCounts(uint64_t items, uint64_t bytes) {
+    if (monitor != nullptr) {
+        monitor->getStats().addCounts(phase, items, bytes);
+    }
+}
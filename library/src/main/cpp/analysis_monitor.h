@@ -0,0 +1,74 @@
+#ifndef ANALYSIS_MONITOR_H
+#define ANALYSIS_MONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "analysis_stats.h"
+
+// 取消标记，由ArkTS侧的CancelToken持有并在工作线程中查询
+using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+// 分析进度
+struct AnalysisProgress {
+    std::string phase;        // 当前阶段：read/translate/serialize/parse/index/query
+    uint64_t bytes;           // 已处理的字节数
+    uint64_t totalBytes;      // 输入文件总字节数，未知时为0
+    uint64_t nodes;           // 已处理的节点数，query阶段为已完成的目标数
+    uint64_t edges;           // 已处理的边数
+
+    AnalysisProgress() : bytes(0), totalBytes(0), nodes(0), edges(0) {}
+};
+
+// 长时间分析的进度上报与取消检查，可在并行查询的多个工作线程中使用
+class AnalysisMonitor {
+public:
+    using ProgressCallback = std::function<void(const AnalysisProgress& progress)>;
+
+    AnalysisMonitor(const CancelFlag& cancelFlag_ = nullptr, const ProgressCallback& callback_ = nullptr)
+        : cancelFlag(cancelFlag_), callback(callback_) {}
+
+    bool isCancelled() const {
+        return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
+    }
+
+    // 上报进度，阶段切换时立即回调，同一阶段内按时间间隔节流；返回false表示已取消
+    bool report(const char* phase, uint64_t bytes, uint64_t totalBytes, uint64_t nodes, uint64_t edges);
+
+    AnalysisStats& getStats() { return stats; }
+    // 子任务使用自己的monitor时共享同一个取消标记
+    const CancelFlag& getCancelFlag() const { return cancelFlag; }
+
+private:
+    AnalysisStats stats;
+    CancelFlag cancelFlag;
+    ProgressCallback callback;
+    std::mutex mutex;
+    std::string lastPhase;
+    std::chrono::steady_clock::time_point lastReportTime;
+};
+
+// 统计一个阶段的墙钟时间和当前线程的CPU时间，离开作用域时计入monitor；monitor为空时不统计
+class ScopedPhase {
+public:
+    ScopedPhase(AnalysisMonitor* monitor_, const char* phase_);
+    ~ScopedPhase();
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    void addCounts(uint64_t items, uint64_t bytes);
+    // 提前结束计时，之后的析构不再重复统计
+    void end();
+
+private:
+    AnalysisMonitor* monitor;
+    const char* phase;
+    std::chrono::steady_clock::time_point wallStart;
+    uint64_t cpuStart;
+};
+
+#endif // ANALYSIS_MONITOR_H
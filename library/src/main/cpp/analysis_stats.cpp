@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <unistd.h>
+#include "analysis_stats.h"
+
+namespace {
+std::mutex publishMutex;
+StatsSnapshot lastStats;
+bool hasLastStats = false;
+std::string dumpPath;
+
+// 从/proc/self/statm读取当前常驻内存(KB)，读取失败时返回0
+uint64_t currentRssKb() {
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp == nullptr) {
+        return 0;
+    }
+    unsigned long long sizePages = 0;
+    unsigned long long residentPages = 0;
+    int fields = fscanf(fp, "%llu %llu", &sizePages, &residentPages);
+    fclose(fp);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (fields != 2 || pageSize <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(residentPages) * static_cast<uint64_t>(pageSize) / 1024;
+}
+
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+}
+
+std::string StatsSnapshot::toJson() const {
+    std::string json = "{\"call\":";
+    appendJsonString(json, call);
+    json += ",\"timestampMs\":" + std::to_string(timestampMs);
+    json += ",\"rssKb\":" + std::to_string(rssKb);
+    json += ",\"rssDeltaKb\":" + std::to_string(rssDeltaKb);
+    json += ",\"phases\":[";
+    for (size_t i = 0; i < phases.size(); i++) {
+        const PhaseStats& phase = phases[i];
+        json += i == 0 ? "{\"name\":" : ",{\"name\":";
+        appendJsonString(json, phase.name);
+        json += ",\"calls\":" + std::to_string(phase.calls);
+        json += ",\"wallNs\":" + std::to_string(phase.wallNs);
+        json += ",\"cpuNs\":" + std::to_string(phase.cpuNs);
+        json += ",\"items\":" + std::to_string(phase.items);
+        json += ",\"bytes\":" + std::to_string(phase.bytes) + "}";
+    }
+    json += "]}";
+    return json;
+}
+
+AnalysisStats::AnalysisStats() : startRssKb(currentRssKb()), highRssKb(startRssKb) {}
+
+PhaseStats& AnalysisStats::findPhase(const char* phase) {
+    for (PhaseStats& stats : phases) {
+        if (stats.name == phase) {
+            return stats;
+        }
+    }
+    phases.emplace_back();
+    phases.back().name = phase;
+    return phases.back();
+}
+
+void AnalysisStats::addTime(const char* phase, uint64_t wallNs, uint64_t cpuNs) {
+    // 阶段结束时中间数据通常还没释放，在这里采样比调用结束时更接近本次调用的内存高点
+    uint64_t rssKb = currentRssKb();
+    std::lock_guard<std::mutex> lock(mutex);
+    highRssKb = std::max(highRssKb, rssKb);
+    PhaseStats& stats = findPhase(phase);
+    stats.calls++;
+    stats.wallNs += wallNs;
+    stats.cpuNs += cpuNs;
+}
+
+void AnalysisStats::addCounts(const char* phase, uint64_t items, uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    PhaseStats& stats = findPhase(phase);
+    stats.items += items;
+    stats.bytes += bytes;
+}
+
+void AnalysisStats::merge(const std::vector<PhaseStats>& other) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const PhaseStats& phase : other) {
+        PhaseStats& stats = findPhase(phase.name.c_str());
+        stats.calls += phase.calls;
+        stats.wallNs += phase.wallNs;
+        stats.cpuNs += phase.cpuNs;
+        stats.items += phase.items;
+        stats.bytes += phase.bytes;
+    }
+}
+
+StatsSnapshot AnalysisStats::snapshot(const std::string& call) const {
+    StatsSnapshot result;
+    result.call = call;
+    result.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    // 不用getrusage的ru_maxrss：那是进程生命周期内的峰值，反映不出本次调用
+    result.rssKb = currentRssKb();
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t highKb = std::max(highRssKb, result.rssKb);
+    result.rssDeltaKb = static_cast<int64_t>(highKb) - static_cast<int64_t>(startRssKb);
+    result.phases = phases;
+    return result;
+}
+
+void AnalysisStats::publish(const StatsSnapshot& stats) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    lastStats = stats;
+    hasLastStats = true;
+    if (dumpPath.empty()) {
+        return;
+    }
+    FILE* fp = fopen(dumpPath.c_str(), "a");
+    if (fp != nullptr) {
+        std::string line = stats.toJson() + "\n";
+        fwrite(line.data(), 1, line.size(), fp);
+        fclose(fp);
+    }
+}
+
+bool AnalysisStats::getLast(StatsSnapshot& stats) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (hasLastStats) {
+        stats = lastStats;
+    }
+    return hasLastStats;
+}
+
+void AnalysisStats::setDumpPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    dumpPath = path;
+}
@@ -0,0 +1,62 @@
+#ifndef ANALYSIS_STATS_H
+#define ANALYSIS_STATS_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 单个阶段的耗时和计数，同一阶段多次执行时累加
+struct PhaseStats {
+    std::string name;
+    uint64_t calls;
+    uint64_t wallNs;    // 墙钟时间，并行执行时为各线程之和
+    uint64_t cpuNs;     // 执行该阶段的线程CPU时间之和
+    uint64_t items;     // 处理的节点/边/目标数
+    uint64_t bytes;     // 读写的字节数
+
+    PhaseStats() : calls(0), wallNs(0), cpuNs(0), items(0), bytes(0) {}
+};
+
+// 一次NAPI调用的统计结果
+struct StatsSnapshot {
+    std::string call;
+    int64_t timestampMs;
+    uint64_t rssKb;       // 快照时进程的常驻内存
+    int64_t rssDeltaKb;   // 各阶段结束时采样的常驻内存最大值减去调用开始时的值，同时进行的调用会互相计入
+    std::vector<PhaseStats> phases;
+
+    StatsSnapshot() : timestampMs(0), rssKb(0), rssDeltaKb(0) {}
+
+    std::string toJson() const;
+};
+
+// 分析过程中按阶段收集耗时和计数，可在多个工作线程中使用
+class AnalysisStats {
+public:
+    // 记录调用开始时的常驻内存
+    AnalysisStats();
+
+    void addTime(const char* phase, uint64_t wallNs, uint64_t cpuNs);
+    void addCounts(const char* phase, uint64_t items, uint64_t bytes);
+    StatsSnapshot snapshot(const std::string& call) const;
+    // 累加另一次分析的各阶段统计，批量分析时汇总各个dump
+    void merge(const std::vector<PhaseStats>& other);
+
+    // 保存为最近一次调用的统计，设置了输出路径时追加一行JSON；只在JS线程中调用，
+    // 同步调用返回后getLast取到的就是它自己的统计
+    static void publish(const StatsSnapshot& stats);
+    static bool getLast(StatsSnapshot& stats);
+    // 为空时不输出
+    static void setDumpPath(const std::string& path);
+
+private:
+    PhaseStats& findPhase(const char* phase);
+
+    mutable std::mutex mutex;
+    std::vector<PhaseStats> phases;  // 按首次出现的顺序
+    uint64_t startRssKb;
+    uint64_t highRssKb;              // 各阶段结束时采样的最大值
+};
+
+#endif // ANALYSIS_STATS_H
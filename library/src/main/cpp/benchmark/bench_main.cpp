@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "analysis_monitor.h"
+#include "heap_snapshot_parser.h"
+#include "rawheap_generator.h"
+#include "rawheap_translate.h"
+
+// 主机侧基准测试：生成合成rawheap，依次测量转换、序列化、解析和路径查询，不依赖NAPI
+namespace {
+struct BenchOptions {
+    RawheapGeneratorOptions generator;
+    uint32_t queries;
+    int maxDepth;
+    std::string workDir;
+    bool keepFiles;
+    bool json;
+    bool hashNodes;   // 按DevTools格式生成"Int:<hash>"节点，默认与分析流程一样只写hash索引
+
+    BenchOptions() : queries(100), maxDepth(10), workDir("."), keepFiles(false), json(false), hashNodes(false) {}
+};
+
+void printUsage(const char* program) {
+    printf("usage: %s [options]\n"
+           "  --version <1|2>        rawheap format version (default 2)\n"
+           "  --nodes <n>            object count (default 100000)\n"
+           "  --fanout <n>           average references per container (default 4)\n"
+           "  --strings <n>          distinct names per string pool (default 1000)\n"
+           "  --hash-density <f>     fraction of objects carrying a hash (default 0.1)\n"
+           "  --roots <n>            root count (default 16)\n"
+           "  --seed <n>             random seed (default 1)\n"
+           "  --queries <n>          path queries to run (default 100)\n"
+           "  --depth <n>            max path depth (default 10)\n"
+           "  --dir <path>           directory for generated files (default .)\n"
+           "  --keep                 keep generated files\n"
+           "  --hash-nodes           translate hashes to Int:<hash> nodes as for DevTools\n"
+           "  --json                 print stats as JSON lines\n", program);
+}
+
+bool parseArgs(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--keep") {
+            options.keepFiles = true;
+            continue;
+        }
+        if (arg == "--json") {
+            options.json = true;
+            continue;
+        }
+        if (arg == "--hash-nodes") {
+            options.hashNodes = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--version") {
+            options.generator.version = atoi(value);
+        } else if (arg == "--nodes") {
+            options.generator.nodeCount = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (arg == "--fanout") {
+            options.generator.fanout = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (arg == "--strings") {
+            options.generator.stringCount = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (arg == "--hash-density") {
+            options.generator.hashDensity = atof(value);
+        } else if (arg == "--roots") {
+            options.generator.rootCount = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (arg == "--seed") {
+            options.generator.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (arg == "--queries") {
+            options.queries = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        } else if (arg == "--depth") {
+            options.maxDepth = atoi(value);
+        } else if (arg == "--dir") {
+            options.workDir = value;
+        } else {
+            return false;
+        }
+    }
+    return options.generator.version == 1 || options.generator.version == 2;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 每个阶段一行：耗时、CPU时间、条目吞吐和字节吞吐
+void printStats(const StatsSnapshot& stats, bool json) {
+    if (json) {
+        printf("%s\n", stats.toJson().c_str());
+        return;
+    }
+    printf("[%s] rss %.1f MB, +%.1f MB during the call\n", stats.call.c_str(), stats.rssKb / 1024.0,
+           stats.rssDeltaKb / 1024.0);
+    printf("  %-16s %6s %10s %10s %12s %14s %10s\n", "phase", "calls", "wall ms", "cpu ms", "items",
+           "items/s", "MB/s");
+    for (const PhaseStats& phase : stats.phases) {
+        double wallMs = phase.wallNs / 1e6;
+        double seconds = phase.wallNs / 1e9;
+        double itemRate = seconds > 0 ? phase.items / seconds : 0;
+        double byteRate = seconds > 0 ? phase.bytes / seconds / (1024.0 * 1024.0) : 0;
+        printf("  %-16s %6llu %10.2f %10.2f %12llu %14.0f %10.1f\n", phase.name.c_str(),
+               static_cast<unsigned long long>(phase.calls), wallMs, phase.cpuNs / 1e6,
+               static_cast<unsigned long long>(phase.items), itemRate, byteRate);
+    }
+}
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.json) {
+        // 转换日志写在std::cout上，JSON模式下关闭，保证输出每行都是JSON
+        std::cout.setstate(std::ios::failbit);
+    }
+    const RawheapGeneratorOptions& gen = options.generator;
+    std::string prefix = options.workDir + "/bench_v" + std::to_string(gen.version) + "_" +
+                         std::to_string(gen.nodeCount);
+    std::string rawheapPath = prefix + ".rawheap";
+    std::string snapshotPath = prefix + ".heapsnapshot";
+
+    auto start = std::chrono::steady_clock::now();
+    GeneratedRawheap generated;
+    if (!generateRawheap(rawheapPath, gen, generated)) {
+        fprintf(stderr, "failed to generate %s\n", rawheapPath.c_str());
+        return 1;
+    }
+    if (!options.json) {
+        printf("generated v%d rawheap: %llu objects, %llu refs, %llu hashes, %.1f MB in %.2f ms\n", gen.version,
+               static_cast<unsigned long long>(generated.objectCount),
+               static_cast<unsigned long long>(generated.refCount),
+               static_cast<unsigned long long>(generated.hashes.size()),
+               generated.fileSize / (1024.0 * 1024.0), elapsedMs(start));
+    }
+
+    // 转换阶段的serialize即HeapSnapshotJSONSerializer的耗时
+    AnalysisMonitor translateMonitor;
+    if (!rawheap_translate::RawHeap::TranslateRawheap(rawheapPath, snapshotPath, &translateMonitor,
+                                                      options.hashNodes)) {
+        fprintf(stderr, "failed to translate %s\n", rawheapPath.c_str());
+        return 1;
+    }
+    printStats(translateMonitor.getStats().snapshot("translateRawheap"), options.json);
+
+    // 不使用sidecar索引，每次都测量完整的JSON解析和建索引
+    AnalysisMonitor parseMonitor;
+    TaskHeapSnapshot snapshot(snapshotPath, false);
+    if (!snapshot.parseSnapshot(&parseMonitor)) {
+        fprintf(stderr, "failed to parse %s\n", snapshotPath.c_str());
+        return 1;
+    }
+    printStats(parseMonitor.getStats().snapshot("parseSnapshot"), options.json);
+
+    AnalysisMonitor queryMonitor;
+    uint32_t queryCount = std::min<uint32_t>(options.queries, static_cast<uint32_t>(generated.hashes.size()));
+    uint32_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < queryCount; i++) {
+        std::string name = "Int:" + std::to_string(generated.hashes[i]);
+        if (!snapshot.getShortestPathToGCRootByName(name, options.maxDepth, &queryMonitor).empty()) {
+            found++;
+        }
+    }
+    double queryMs = elapsedMs(start);
+    printStats(queryMonitor.getStats().snapshot("getShortestPathToGCRoot"), options.json);
+    if (!options.json) {
+        printf("queries: %u, paths found: %u, %.3f ms/query\n", queryCount, found,
+               queryCount > 0 ? queryMs / queryCount : 0.0);
+    }
+
+    if (!options.keepFiles) {
+        remove(rawheapPath.c_str());
+        remove(snapshotPath.c_str());
+    }
+    return 0;
+}
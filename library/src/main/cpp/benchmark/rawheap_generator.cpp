@@ -0,0 +1,401 @@
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include "rawheap_generator.h"
+
+namespace {
+// JSType按元数据type_enum中的顺序编号
+enum GeneratedType : uint32_t {
+    TYPE_INVALID = 0,
+    TYPE_HCLASS,
+    TYPE_LINE_STRING,
+    TYPE_TAGGED_ARRAY,
+    TYPE_JS_OBJECT,
+    TYPE_JS_NATIVE_POINTER,
+    TYPE_COUNT
+};
+
+// 与下面的布局一致：HClass在偏移8处保存JSType，普通对象的内联属性从偏移24开始，数组元素从偏移16开始
+const char* GENERATED_METADATA =
+    "{\"version\":\"1.0.0\","
+    "\"type_enum\":{\"INVALID\":0,\"HCLASS\":0,\"LINE_STRING\":2,\"TAGGED_ARRAY\":1,\"JS_OBJECT\":3,"
+    "\"JS_NATIVE_POINTER\":8},"
+    "\"type_list\":["
+    "{\"name\":\"HCLASS\",\"visit_type\":\"\",\"end_offset\":16,\"parents\":[],"
+    "\"offsets\":[{\"name\":\"BitField\",\"offset\":8,\"size\":4}]},"
+    "{\"name\":\"LINE_STRING\",\"visit_type\":\"\",\"end_offset\":16,\"parents\":[],"
+    "\"offsets\":[{\"name\":\"Length\",\"offset\":8,\"size\":4}]},"
+    "{\"name\":\"TAGGED_ARRAY\",\"visit_type\":\"Array\",\"end_offset\":16,\"parents\":[],"
+    "\"offsets\":[{\"name\":\"Length\",\"offset\":8,\"size\":4},{\"name\":\"Data\",\"offset\":16,\"size\":8}]},"
+    "{\"name\":\"JS_OBJECT\",\"visit_type\":\"\",\"end_offset\":24,\"parents\":[],"
+    "\"offsets\":[{\"name\":\"Properties\",\"offset\":8,\"size\":8},{\"name\":\"Elements\",\"offset\":16,\"size\":8}]},"
+    "{\"name\":\"JS_NATIVE_POINTER\",\"visit_type\":\"\",\"end_offset\":16,\"parents\":[],"
+    "\"offsets\":[{\"name\":\"BindingSize\",\"offset\":8,\"size\":4}]}],"
+    "\"type_layout\":{"
+    "\"Dictionary_layout\":{\"key_index\":0,\"value_index\":1,\"detail_index\":2,\"entry_size\":3,\"header_size\":3},"
+    "\"Type_range\":{\"string_first\":\"LINE_STRING\",\"string_last\":\"LINE_STRING\","
+    "\"js_object_first\":\"JS_OBJECT\",\"js_object_last\":\"JS_OBJECT\"}}}";
+
+const uint32_t OBJECT_HEADER_SIZE = 16;       // HClass指针 + 一个字段
+const uint32_t JS_OBJECT_FIELDS_END = 24;
+const uint32_t SLOT_SIZE = 8;
+const uint64_t V1_ADDRESS_BASE = 0x10000000ULL;
+const uint8_t V2_UNDEFINED_TAG = 0x42;
+const uint8_t V2_INT_TAG = 0x04;
+
+struct GeneratedObject {
+    uint32_t type;
+    uint32_t hclass;         // HClass对象的下标
+    uint32_t size;
+    uint64_t id;             // 高32位为hash
+    uint32_t nativeSize;
+    int32_t name;            // 字符串表中的下标，-1表示使用类型名
+    std::vector<uint32_t> refs;
+};
+
+// 只追加的二进制缓冲区，rawheap中的数值均为小端
+class ByteBuffer {
+public:
+    void u8(uint8_t value) { data.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value) { append(&value, sizeof(value)); }
+    void u64(uint64_t value) { append(&value, sizeof(value)); }
+    void append(const void* bytes, size_t size) {
+        const char* begin = static_cast<const char*>(bytes);
+        data.insert(data.end(), begin, begin + size);
+    }
+    void zeros(size_t size) { data.resize(data.size() + size, 0); }
+    size_t size() const { return data.size(); }
+
+    std::vector<char> data;
+};
+
+bool isContainer(uint32_t type) {
+    return type == TYPE_JS_OBJECT || type == TYPE_TAGGED_ARRAY;
+}
+
+uint32_t objectSize(const GeneratedObject& object) {
+    switch (object.type) {
+        case TYPE_JS_OBJECT:
+            return JS_OBJECT_FIELDS_END + SLOT_SIZE * static_cast<uint32_t>(object.refs.size());
+        case TYPE_TAGGED_ARRAY:
+            return OBJECT_HEADER_SIZE + SLOT_SIZE * static_cast<uint32_t>(object.refs.size());
+        default:
+            return OBJECT_HEADER_SIZE;
+    }
+}
+
+// 生成对象图：每类对象一个HClass，前rootCount个普通对象为根；
+// 其余对象先挂到一个更早的容器上保证可达，再按fanout补充随机引用
+void buildObjects(const RawheapGeneratorOptions& options, std::vector<GeneratedObject>& objects,
+                  std::vector<std::string>& strings, std::vector<int32_t>& hashes) {
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    uint32_t stringCount = options.stringCount > 0 ? options.stringCount : 1;
+    std::uniform_int_distribution<uint32_t> pickString(0, stringCount - 1);
+
+    // 前一半为对象名称，后一半为字符串内容
+    strings.clear();
+    for (uint32_t i = 0; i < stringCount; i++) {
+        strings.push_back("Class" + std::to_string(i));
+    }
+    for (uint32_t i = 0; i < stringCount; i++) {
+        strings.push_back("string_" + std::to_string(i));
+    }
+
+    uint32_t hclassCount = TYPE_COUNT - 1;
+    uint32_t rootCount = options.rootCount > 0 ? options.rootCount : 1;
+    uint32_t total = hclassCount + std::max(options.nodeCount, rootCount);
+    objects.assign(total, GeneratedObject());
+    for (uint32_t i = 0; i < hclassCount; i++) {
+        GeneratedObject& hclass = objects[i];
+        hclass.type = TYPE_HCLASS;
+        hclass.hclass = 0;   // 所有HClass的HClass都是第一个HClass，它指向自己
+        hclass.name = -1;
+    }
+
+    std::vector<uint32_t> containers;
+    uint32_t nextHash = 1;
+    for (uint32_t i = hclassCount; i < total; i++) {
+        GeneratedObject& object = objects[i];
+        double roll = unit(rng);
+        if (i < hclassCount + rootCount || roll < 0.6) {
+            object.type = TYPE_JS_OBJECT;
+        } else if (roll < 0.75) {
+            object.type = TYPE_TAGGED_ARRAY;
+        } else if (roll < 0.95) {
+            object.type = TYPE_LINE_STRING;
+        } else {
+            object.type = TYPE_JS_NATIVE_POINTER;
+        }
+        object.hclass = object.type - 1;
+        object.name = -1;
+        object.nativeSize = object.type == TYPE_JS_NATIVE_POINTER ? 64 : 0;
+        if (object.type == TYPE_JS_OBJECT) {
+            object.name = static_cast<int32_t>(pickString(rng));
+        } else if (object.type == TYPE_LINE_STRING) {
+            object.name = static_cast<int32_t>(stringCount + pickString(rng));
+        }
+
+        uint64_t hash = 0;
+        if (object.type == TYPE_JS_OBJECT && unit(rng) < options.hashDensity) {
+            // hash按int32传给分析接口，保持为正数
+            hash = nextHash++ * 2654435761U % 0x7FFFFFFFU;
+            if (hash == 0) {
+                hash = nextHash++;
+            }
+            hashes.push_back(static_cast<int32_t>(hash));
+        }
+        object.id = (hash << 32) | (2ULL * i + 3);
+
+        if (i >= hclassCount + rootCount) {
+            std::uniform_int_distribution<size_t> pickParent(0, containers.size() - 1);
+            objects[containers[pickParent(rng)]].refs.push_back(i);
+        }
+        if (isContainer(object.type)) {
+            containers.push_back(i);
+        }
+    }
+
+    std::uniform_int_distribution<uint32_t> pickTarget(hclassCount, total - 1);
+    std::uniform_int_distribution<uint32_t> pickFanout(0, options.fanout * 2);
+    for (uint32_t index : containers) {
+        GeneratedObject& object = objects[index];
+        uint32_t target = pickFanout(rng);
+        while (object.refs.size() < target) {
+            uint32_t to = pickTarget(rng);
+            if (to != index) {
+                object.refs.push_back(to);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < total; i++) {
+        objects[i].size = objectSize(objects[i]);
+        if (i < hclassCount) {
+            objects[i].id = 2ULL * i + 3;
+        }
+    }
+}
+
+uint64_t v1Address(uint32_t index) {
+    return V1_ADDRESS_BASE + static_cast<uint64_t>(index) * SLOT_SIZE * 8;
+}
+
+// V2中对象地址为32位，8字节对齐保证最低字节不会被当成特殊值的标记
+uint32_t v2Address(uint32_t index) {
+    return (index + 1) * SLOT_SIZE;
+}
+
+// 字符串表：{长度, 对象数} + 对象地址 + 以0结尾的字符串
+template <typename AddressFn>
+void writeStringTable(ByteBuffer& out, const std::vector<std::string>& strings,
+                      const std::vector<std::vector<uint32_t>>& owners, bool wideAddress, AddressFn address) {
+    uint32_t used = 0;
+    for (const auto& list : owners) {
+        used += list.empty() ? 0 : 1;
+    }
+    out.u32(used);
+    out.u32(0);
+    for (size_t i = 0; i < strings.size(); i++) {
+        if (owners[i].empty()) {
+            continue;
+        }
+        out.u32(static_cast<uint32_t>(strings[i].size()));
+        out.u32(static_cast<uint32_t>(owners[i].size()));
+        for (uint32_t index : owners[i]) {
+            if (wideAddress) {
+                out.u64(v1Address(index));
+            } else {
+                out.u32(address(index));
+            }
+        }
+        out.append(strings[i].c_str(), strings[i].size() + 1);
+    }
+}
+
+void writeV1Body(ByteBuffer& out, const std::vector<GeneratedObject>& objects, uint32_t rootBegin, uint32_t rootEnd,
+                 const std::vector<std::string>& strings, const std::vector<std::vector<uint32_t>>& owners,
+                 std::vector<uint32_t>& sections) {
+    out.zeros(sizeof(uint64_t));   // V1没有版本号，前8字节为0
+
+    uint32_t rootOffset = static_cast<uint32_t>(out.size());
+    out.u32(rootEnd - rootBegin);
+    out.u32(sizeof(uint64_t));
+    for (uint32_t i = rootBegin; i < rootEnd; i++) {
+        out.u64(v1Address(i));
+    }
+
+    uint32_t stringOffset = static_cast<uint32_t>(out.size());
+    writeStringTable(out, strings, owners, true, v1Address);
+
+    // 对象表：{对象数, 表项大小} + 表项{地址, id, 大小, 数据偏移} + 对象内存
+    uint32_t objectOffset = static_cast<uint32_t>(out.size());
+    const uint32_t itemSize = sizeof(uint64_t) * 2 + sizeof(uint32_t) * 2;
+    uint32_t tableSize = static_cast<uint32_t>(objects.size()) * itemSize;
+    out.u32(static_cast<uint32_t>(objects.size()));
+    out.u32(itemSize);
+    uint32_t memOffset = tableSize;
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        out.u64(v1Address(i));
+        out.u64(objects[i].id);
+        out.u32(objects[i].size);
+        out.u32(memOffset);
+        memOffset += objects[i].size;
+    }
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        const GeneratedObject& object = objects[i];
+        size_t start = out.size();
+        out.u64(v1Address(object.hclass));
+        switch (object.type) {
+            case TYPE_HCLASS:
+                out.u32(i + 1);   // 第i个HClass描述JSType为i + 1的对象
+                break;
+            case TYPE_JS_OBJECT:
+                out.u64(0);
+                out.u64(0);
+                for (uint32_t to : object.refs) {
+                    out.u64(v1Address(to));
+                }
+                break;
+            case TYPE_TAGGED_ARRAY:
+                out.u32(static_cast<uint32_t>(object.refs.size()));
+                out.u32(0);
+                for (uint32_t to : object.refs) {
+                    out.u64(v1Address(to));
+                }
+                break;
+            case TYPE_JS_NATIVE_POINTER:
+                out.u32(object.nativeSize);
+                break;
+            default:
+                break;
+        }
+        out.zeros(start + object.size - out.size());
+    }
+    uint32_t objectTotal = static_cast<uint32_t>(out.size()) - objectOffset;
+
+    sections = {rootOffset, stringOffset - rootOffset, stringOffset, objectOffset - stringOffset,
+                objectOffset, objectTotal};
+}
+
+void writeV2Slot(ByteBuffer& out, uint32_t address) {
+    out.u32(address);
+}
+
+void writeV2Int(ByteBuffer& out, uint32_t value) {
+    out.u8(V2_INT_TAG);
+    out.u32(value);
+}
+
+void writeV2Body(ByteBuffer& out, const std::vector<GeneratedObject>& objects, uint32_t rootBegin, uint32_t rootEnd,
+                 const std::vector<std::string>& strings, const std::vector<std::vector<uint32_t>>& owners,
+                 std::vector<uint32_t>& sections) {
+    const char version[8] = {'2', '.', '0', '.', '0', 0, 0, 0};
+    out.append(version, sizeof(version));
+
+    // 对象表：{对象数, 表项大小} + 表项{地址, 大小, id, native大小, JSType} + 按对象顺序编码的引用流
+    uint32_t objectOffset = static_cast<uint32_t>(out.size());
+    const uint32_t itemSize = sizeof(uint32_t) * 4 + sizeof(uint64_t);
+    out.u32(static_cast<uint32_t>(objects.size()));
+    out.u32(itemSize);
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        out.u32(v2Address(i));
+        out.u32(objects[i].size);
+        out.u64(objects[i].id);
+        out.u32(objects[i].nativeSize);
+        out.u32(objects[i].type);
+    }
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        const GeneratedObject& object = objects[i];
+        writeV2Slot(out, v2Address(object.hclass));
+        switch (object.type) {
+            case TYPE_HCLASS:
+                writeV2Int(out, i + 1);
+                break;
+            case TYPE_JS_OBJECT:
+                out.u8(V2_UNDEFINED_TAG);
+                out.u8(V2_UNDEFINED_TAG);
+                for (uint32_t to : object.refs) {
+                    writeV2Slot(out, v2Address(to));
+                }
+                break;
+            case TYPE_TAGGED_ARRAY:
+                writeV2Int(out, static_cast<uint32_t>(object.refs.size()));
+                for (uint32_t to : object.refs) {
+                    writeV2Slot(out, v2Address(to));
+                }
+                break;
+            case TYPE_JS_NATIVE_POINTER:
+                writeV2Int(out, object.nativeSize);
+                break;
+            default:
+                break;   // 字符串只有HClass
+        }
+    }
+    uint32_t objectTotal = static_cast<uint32_t>(out.size()) - objectOffset;
+
+    uint32_t rootOffset = static_cast<uint32_t>(out.size());
+    out.u32(rootEnd - rootBegin);
+    out.u32(sizeof(uint32_t));
+    for (uint32_t i = rootBegin; i < rootEnd; i++) {
+        out.u32(v2Address(i));
+    }
+
+    uint32_t stringOffset = static_cast<uint32_t>(out.size());
+    writeStringTable(out, strings, owners, false, v2Address);
+    uint32_t stringEnd = static_cast<uint32_t>(out.size());
+
+    sections = {rootOffset, stringOffset - rootOffset, stringOffset, stringEnd - stringOffset,
+                objectOffset, objectTotal};
+}
+}
+
+bool generateRawheap(const std::string& path, const RawheapGeneratorOptions& options, GeneratedRawheap& result) {
+    if (options.version != 1 && options.version != 2) {
+        return false;
+    }
+    std::vector<GeneratedObject> objects;
+    std::vector<std::string> strings;
+    result = GeneratedRawheap();
+    buildObjects(options, objects, strings, result.hashes);
+
+    std::vector<std::vector<uint32_t>> owners(strings.size());
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        if (objects[i].name >= 0) {
+            owners[objects[i].name].push_back(i);
+        }
+        result.refCount += objects[i].refs.size();
+    }
+    result.objectCount = objects.size();
+
+    uint32_t rootBegin = TYPE_COUNT - 1;
+    uint32_t rootEnd = rootBegin + std::max<uint32_t>(options.rootCount, 1);
+    ByteBuffer out;
+    std::vector<uint32_t> sections;
+    if (options.version == 1) {
+        writeV1Body(out, objects, rootBegin, rootEnd, strings, owners, sections);
+    } else {
+        writeV2Body(out, objects, rootBegin, rootEnd, strings, owners, sections);
+    }
+
+    // 段表放在元数据之前：段偏移数组 + {段数, 4}，文件末尾为{元数据偏移, 元数据大小}
+    for (uint32_t value : sections) {
+        out.u32(value);
+    }
+    out.u32(static_cast<uint32_t>(sections.size()));
+    out.u32(sizeof(uint32_t));
+    uint32_t metaOffset = static_cast<uint32_t>(out.size());
+    uint32_t metaSize = static_cast<uint32_t>(strlen(GENERATED_METADATA));
+    out.append(GENERATED_METADATA, metaSize);
+    out.u32(metaOffset);
+    out.u32(metaSize);
+
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (fp == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(out.data.data(), 1, out.size(), fp) == out.size();
+    ok = fclose(fp) == 0 && ok;
+    result.fileSize = out.size();
+    return ok;
+}
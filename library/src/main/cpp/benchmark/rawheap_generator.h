@@ -0,0 +1,35 @@
+#ifndef RAWHEAP_GENERATOR_H
+#define RAWHEAP_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 合成rawheap的参数
+struct RawheapGeneratorOptions {
+    int version;             // rawheap格式版本，1或2
+    uint32_t nodeCount;      // 对象数量，不含HClass
+    uint32_t fanout;         // 容器对象(普通对象和数组)的平均引用数
+    uint32_t stringCount;    // 对象名称和字符串内容各自的不同取值数量
+    double hashDensity;      // 带hash的普通对象比例
+    uint32_t rootCount;      // 根对象数量
+    uint32_t seed;
+
+    RawheapGeneratorOptions()
+        : version(2), nodeCount(100000), fanout(4), stringCount(1000), hashDensity(0.1), rootCount(16), seed(1) {}
+};
+
+// 生成结果，hashes可直接作为路径查询的目标
+struct GeneratedRawheap {
+    std::vector<int32_t> hashes;
+    uint64_t objectCount;    // 写入对象表的对象数，含HClass
+    uint64_t refCount;       // 对象之间的引用数
+    uint64_t fileSize;
+
+    GeneratedRawheap() : objectCount(0), refCount(0), fileSize(0) {}
+};
+
+// 按参数生成一个可被TranslateRawheap解析的rawheap文件，元数据只包含生成器用到的几种类型
+bool generateRawheap(const std::string& path, const RawheapGeneratorOptions& options, GeneratedRawheap& result);
+
+#endif // RAWHEAP_GENERATOR_H
@@ -0,0 +1,653 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "analysis_monitor.h"
+#include "hash_analysis.h"
+#include "heap_diff.h"
+#include "heap_snapshot_parser.h"
+#include "rawheap_translate.h"
+#include "worker_pool.h"
+
+// 命令行工具：在Linux主机上转换rawheap、批量查询泄漏对象的引用链并比较先后两个dump，结果输出为JSON或文本
+namespace {
+enum class OutputFormat { JSON, TEXT };
+
+struct CliOptions {
+    std::string command;
+    std::vector<std::string> inputs;
+    std::vector<HashTarget> targets;
+    size_t threads;          // 0表示按核数
+    OutputFormat format;
+    int maxDepth;
+    std::string outputPath;  // 为空时输出到stdout
+    bool useIndex;
+    bool keepSnapshot;
+    bool quickCheck;         // rawheap先扫描对象表，跳过不含目标的dump
+    bool hashIndex;          // translate时只写hash索引，不生成DevTools使用的hash节点
+    bool approximate;        // analyze时rawheap只做对象统计，目标只给出精确大小
+    double sampleRate;       // 为0时统计全部对象
+    bool stats;
+    size_t memoryBudget;     // 字节，0表示物理内存的1/4
+
+    CliOptions()
+        : threads(0), format(OutputFormat::JSON), maxDepth(10), useIndex(false), keepSnapshot(false), quickCheck(false),
+          hashIndex(false), approximate(false), sampleRate(0), stats(false), memoryBudget(0) {}
+};
+
+void printUsage() {
+    fprintf(stderr,
+            "usage:\n"
+            "  leakguard translate <input.rawheap> <output.heapsnapshot> [options]\n"
+            "  leakguard analyze <dump>... (--hash <n>[,<n>...] | --hashes <file>) [options]\n"
+            "  leakguard summary <input.rawheap> [--hash <n>[,<n>...] | --hashes <file>] [options]\n"
+            "  leakguard diff <before> <after> [options]\n"
+            "\n"
+            "  dump is a .rawheap (translated to a temporary snapshot) or a .heapsnapshot\n"
+            "  --hashes file holds one target per line: <hash> [name], '-' reads stdin\n"
+            "  summary counts objects and sizes per type and constructor name without translating,\n"
+            "  target hashes are always counted exactly and listed\n"
+            "  diff matches objects of two dumps of one process by id and reports added, freed and\n"
+            "  surviving objects per constructor name\n"
+            "\n"
+            "options:\n"
+            "  --threads <n>          worker threads, 0 uses cores - 1 (default 0)\n"
+            "  --memory-budget <mb>   memory for dumps analyzed concurrently (default 1/4 of RAM)\n"
+            "  --format <json|text>   output format (default json)\n"
+            "  --depth <n>            max reference chain depth (default 10)\n"
+            "  --output <file>        write results to file instead of stdout\n"
+            "  --index                load/write the sidecar index for .heapsnapshot inputs\n"
+            "  --keep-snapshot        keep snapshots translated from rawheap inputs\n"
+            "  --quick-check          scan rawheap object tables first, only translate dumps holding a target\n"
+            "  --hash-index           translate: write hashes as an index for analyze instead of Int:<hash>\n"
+            "                         nodes (smaller and faster to parse, not shown in DevTools)\n"
+            "  --sample-rate <r>      summary, analyze --approximate: estimate from a fraction (0, 1] of the\n"
+            "                         objects with error bounds, reads faster only on V2 rawheaps\n"
+            "  --approximate          analyze: skip translating rawheap inputs, report a summary and\n"
+            "                         exact target sizes without reference chains\n"
+            "  --stats                include per-phase timings in the output\n"
+            "  --quiet                suppress analyzer logs (written to stderr)\n");
+}
+
+bool parseHash(const std::string& text, int& hash) {
+    char* end = nullptr;
+    long long value = strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        return false;
+    }
+    // 与ArkTS侧一致，hash按int32传递
+    hash = static_cast<int>(static_cast<int32_t>(value));
+    return true;
+}
+
+bool addHashList(const std::string& list, std::vector<HashTarget>& targets) {
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int hash = 0;
+        if (!parseHash(item, hash)) {
+            fprintf(stderr, "invalid hash: %s\n", item.c_str());
+            return false;
+        }
+        targets.emplace_back("", hash);
+    }
+    return true;
+}
+
+bool readHashFile(const std::string& path, std::vector<HashTarget>& targets) {
+    std::ifstream file;
+    std::istream* input = &std::cin;
+    if (path != "-") {
+        file.open(path);
+        if (!file.is_open()) {
+            fprintf(stderr, "cannot open %s\n", path.c_str());
+            return false;
+        }
+        input = &file;
+    }
+    std::string line;
+    while (std::getline(*input, line)) {
+        std::stringstream stream(line);
+        std::string hashText;
+        if (!(stream >> hashText) || hashText[0] == '#') {
+            continue;
+        }
+        int hash = 0;
+        if (!parseHash(hashText, hash)) {
+            fprintf(stderr, "invalid hash: %s\n", hashText.c_str());
+            return false;
+        }
+        std::string name;
+        std::getline(stream >> std::ws, name);
+        targets.emplace_back(name, hash);
+    }
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, CliOptions& options) {
+    if (argc < 2) {
+        return false;
+    }
+    options.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            options.inputs.push_back(arg);
+            continue;
+        }
+        if (arg == "--index") {
+            options.useIndex = true;
+            continue;
+        }
+        if (arg == "--keep-snapshot") {
+            options.keepSnapshot = true;
+            continue;
+        }
+        if (arg == "--hash-index") {
+            options.hashIndex = true;
+            continue;
+        }
+        if (arg == "--quick-check") {
+            options.quickCheck = true;
+            continue;
+        }
+        if (arg == "--approximate") {
+            options.approximate = true;
+            continue;
+        }
+        if (arg == "--stats") {
+            options.stats = true;
+            continue;
+        }
+        if (arg == "--quiet") {
+            // 分析器的日志(std::cout已改写到stderr)和std::cerr都不再输出，本工具自己的错误信息用stderr输出
+            std::cout.setstate(std::ios::failbit);
+            std::cerr.setstate(std::ios::failbit);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--threads") {
+            options.threads = static_cast<size_t>(strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--format") {
+            if (value == "json") {
+                options.format = OutputFormat::JSON;
+            } else if (value == "text") {
+                options.format = OutputFormat::TEXT;
+            } else {
+                fprintf(stderr, "unknown format: %s\n", value.c_str());
+                return false;
+            }
+        } else if (arg == "--memory-budget") {
+            options.memoryBudget = static_cast<size_t>(strtoull(value.c_str(), nullptr, 10)) << 20;
+        } else if (arg == "--sample-rate") {
+            options.sampleRate = strtod(value.c_str(), nullptr);
+            if (!(options.sampleRate > 0 && options.sampleRate <= 1)) {
+                fprintf(stderr, "sample rate must be in (0, 1]: %s\n", value.c_str());
+                return false;
+            }
+        } else if (arg == "--depth") {
+            options.maxDepth = atoi(value.c_str());
+        } else if (arg == "--output") {
+            options.outputPath = value;
+        } else if (arg == "--hash") {
+            if (!addHashList(value, options.targets)) {
+                return false;
+            }
+        } else if (arg == "--hashes") {
+            if (!readHashFile(value, options.targets)) {
+                return false;
+            }
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    if (options.command == "translate") {
+        return options.inputs.size() == 2;
+    }
+    if (options.command == "summary") {
+        return options.inputs.size() == 1;
+    }
+    if (options.command == "analyze") {
+        return !options.inputs.empty() && !options.targets.empty();
+    }
+    if (options.command == "diff") {
+        return options.inputs.size() == 2;
+    }
+    return false;
+}
+
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// 字段名与ArkTS侧的NodeRef/ReferenceChain一致
+void appendChainNode(std::string& out, const ReferenceChainNode& node) {
+    out += "{\"nodeId\":" + std::to_string(node.id) + ",\"name\":";
+    appendJsonString(out, node.name);
+    out += ",\"type\":";
+    appendJsonString(out, node.type);
+    out += ",\"path\":";
+    appendJsonString(out, node.path);
+    out += ",\"line\":" + std::to_string(node.line) + "}";
+}
+
+void appendNodeRef(std::string& out, const NodeRef& nodeRef) {
+    out += "{\"hash\":" + std::to_string(nodeRef.hash) + ",\"name\":";
+    appendJsonString(out, nodeRef.name);
+    out += ",\"selfSize\":" + std::to_string(nodeRef.selfSize);
+    out += ",\"retainedSize\":" + std::to_string(nodeRef.retainedSize) + ",\"ref\":[";
+    for (size_t i = 0; i < nodeRef.refs.size(); i++) {
+        const ReferenceChain& chain = nodeRef.refs[i];
+        out += i == 0 ? "{\"from\":" : ",{\"from\":";
+        appendChainNode(out, chain.referrer);
+        out += ",\"edgeType\":";
+        appendJsonString(out, chain.edge_type);
+        out += ",\"to\":";
+        appendChainNode(out, chain.current_node);
+        out += "}";
+    }
+    out += "]}";
+}
+
+void appendSummaryEntries(std::string& out, const std::vector<rawheap_translate::SummaryEntry>& entries,
+                          bool sampled) {
+    out += '[';
+    for (size_t i = 0; i < entries.size(); i++) {
+        const rawheap_translate::SummaryEntry& entry = entries[i];
+        out += i == 0 ? "{\"name\":" : ",{\"name\":";
+        appendJsonString(out, entry.name);
+        out += ",\"count\":" + std::to_string(entry.count);
+        out += ",\"selfSize\":" + std::to_string(entry.selfSize);
+        out += ",\"nativeSize\":" + std::to_string(entry.nativeSize);
+        if (sampled) {
+            out += ",\"countError\":" + std::to_string(entry.countError);
+            out += ",\"selfSizeError\":" + std::to_string(entry.selfSizeError);
+            out += ",\"nativeSizeError\":" + std::to_string(entry.nativeSizeError);
+        }
+        out += '}';
+    }
+    out += ']';
+}
+
+// 字段名与ArkTS侧的HeapSummary一致
+void appendSummaryJson(std::string& out, const rawheap_translate::HeapSummary& summary) {
+    bool sampled = summary.sampleRate < 1;
+    char rate[32];
+    snprintf(rate, sizeof(rate), "%g", summary.sampleRate);
+    out += "{\"sampleRate\":" + std::string(rate);
+    out += ",\"sampledCount\":" + std::to_string(summary.sampledCount);
+    out += ",\"objectCount\":" + std::to_string(summary.objectCount);
+    out += ",\"selfSize\":" + std::to_string(summary.selfSize);
+    out += ",\"nativeSize\":" + std::to_string(summary.nativeSize);
+    if (sampled) {
+        out += ",\"objectCountError\":" + std::to_string(summary.objectCountError);
+        out += ",\"selfSizeError\":" + std::to_string(summary.selfSizeError);
+        out += ",\"nativeSizeError\":" + std::to_string(summary.nativeSizeError);
+    }
+    out += ",\"types\":";
+    appendSummaryEntries(out, summary.types, sampled);
+    out += ",\"names\":";
+    appendSummaryEntries(out, summary.names, sampled);
+    out += ",\"targets\":[";
+    for (size_t i = 0; i < summary.targets.size(); i++) {
+        const rawheap_translate::SummaryTarget& target = summary.targets[i];
+        out += i == 0 ? "{\"hash\":" : ",{\"hash\":";
+        out += std::to_string(static_cast<int32_t>(target.hash)) + ",\"nodeId\":" + std::to_string(target.nodeId);
+        out += ",\"type\":";
+        appendJsonString(out, target.type);
+        out += ",\"name\":";
+        appendJsonString(out, target.name);
+        out += ",\"selfSize\":" + std::to_string(target.selfSize);
+        out += ",\"nativeSize\":" + std::to_string(target.nativeSize) + "}";
+    }
+    out += "]}";
+}
+
+std::string formatSummaryJson(const rawheap_translate::HeapSummary& summary) {
+    std::string out;
+    appendSummaryJson(out, summary);
+    out += '\n';
+    return out;
+}
+
+// 抽样时数值后附上95%置信区间的半宽
+std::string formatEstimate(uint64_t value, uint64_t error, bool sampled) {
+    std::string text = std::to_string(value);
+    return sampled ? text + "±" + std::to_string(error) : text;
+}
+
+void appendSummaryTable(std::string& out, const char* title,
+                        const std::vector<rawheap_translate::SummaryEntry>& entries, bool sampled) {
+    char line[256];
+    snprintf(line, sizeof(line), "%s\n  %18s %22s %22s  name\n", title, "count", "self", "native");
+    out += line;
+    for (const rawheap_translate::SummaryEntry& entry : entries) {
+        snprintf(line, sizeof(line), "  %18s %22s %22s  ",
+                 formatEstimate(entry.count, entry.countError, sampled).c_str(),
+                 formatEstimate(entry.selfSize, entry.selfSizeError, sampled).c_str(),
+                 formatEstimate(entry.nativeSize, entry.nativeSizeError, sampled).c_str());
+        out += line + entry.name + "\n";
+    }
+}
+
+void appendSummaryText(std::string& out, const rawheap_translate::HeapSummary& summary) {
+    bool sampled = summary.sampleRate < 1;
+    char line[256];
+    snprintf(line, sizeof(line), "%s objects, self %s, native %s",
+             formatEstimate(summary.objectCount, summary.objectCountError, sampled).c_str(),
+             formatEstimate(summary.selfSize, summary.selfSizeError, sampled).c_str(),
+             formatEstimate(summary.nativeSize, summary.nativeSizeError, sampled).c_str());
+    out += line;
+    if (sampled) {
+        snprintf(line, sizeof(line), " (estimated from %llu objects, rate %g)",
+                 static_cast<unsigned long long>(summary.sampledCount), summary.sampleRate);
+        out += line;
+    }
+    out += '\n';
+    appendSummaryTable(out, "by type:", summary.types, sampled);
+    appendSummaryTable(out, "by constructor:", summary.names, sampled);
+    for (const rawheap_translate::SummaryTarget& target : summary.targets) {
+        snprintf(line, sizeof(line), "target hash %d  id %llu  self %llu  native %llu  %s ",
+                 static_cast<int32_t>(target.hash), static_cast<unsigned long long>(target.nodeId),
+                 static_cast<unsigned long long>(target.selfSize), static_cast<unsigned long long>(target.nativeSize),
+                 target.type.c_str());
+        out += line + target.name + "\n";
+    }
+}
+
+std::string formatSummaryText(const rawheap_translate::HeapSummary& summary) {
+    std::string out;
+    appendSummaryText(out, summary);
+    return out;
+}
+
+std::string formatJson(const std::vector<DumpAnalysisResult>& results, bool withStats) {
+    std::string out = "{\"results\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const DumpAnalysisResult& result = results[i];
+        out += i == 0 ? "{\"file\":" : ",{\"file\":";
+        appendJsonString(out, result.file);
+        if (!result.error.empty()) {
+            out += ",\"error\":";
+            appendJsonString(out, result.error);
+        }
+        out += ",\"targets\":[";
+        for (size_t j = 0; j < result.refs.size(); j++) {
+            if (j > 0) {
+                out += ',';
+            }
+            appendNodeRef(out, result.refs[j]);
+        }
+        out += "]";
+        if (result.summary.sampledCount > 0) {
+            out += ",\"summary\":";
+            appendSummaryJson(out, result.summary);
+        }
+        if (withStats) {
+            out += ",\"stats\":" + result.stats.toJson();
+        }
+        out += "}";
+    }
+    out += "]}\n";
+    return out;
+}
+
+std::string formatText(const std::vector<DumpAnalysisResult>& results, size_t targetCount, bool withStats) {
+    std::string out;
+    char line[256];
+    for (const DumpAnalysisResult& result : results) {
+        if (!result.error.empty()) {
+            out += result.file + ": error: " + result.error + "\n";
+            continue;
+        }
+        snprintf(line, sizeof(line), ": %zu of %zu targets retained\n", result.refs.size(), targetCount);
+        out += result.file + line;
+        for (const NodeRef& nodeRef : result.refs) {
+            snprintf(line, sizeof(line), "  hash %d  self %llu  retained %llu  ", nodeRef.hash,
+                     static_cast<unsigned long long>(nodeRef.selfSize),
+                     static_cast<unsigned long long>(nodeRef.retainedSize));
+            out += line + nodeRef.name + "\n";
+            for (const ReferenceChain& chain : nodeRef.refs) {
+                out += "    " + chain.referrer.name + " (" + chain.referrer.type + ") --" + chain.edge_type + "--> " +
+                       chain.current_node.name + " (" + chain.current_node.type + ")\n";
+            }
+        }
+        if (result.summary.sampledCount > 0) {
+            appendSummaryText(out, result.summary);
+        }
+        if (withStats) {
+            for (const PhaseStats& phase : result.stats.phases) {
+                snprintf(line, sizeof(line), "  [%s] %.2f ms, %llu items\n", phase.name.c_str(), phase.wallNs / 1e6,
+                         static_cast<unsigned long long>(phase.items));
+                out += line;
+            }
+        }
+    }
+    return out;
+}
+
+void appendDiffEntry(std::string& out, const HeapDiffEntry& entry) {
+    out += "{\"name\":";
+    appendJsonString(out, entry.name);
+    out += ",\"beforeCount\":" + std::to_string(entry.beforeCount);
+    out += ",\"beforeSize\":" + std::to_string(entry.beforeSize);
+    out += ",\"afterCount\":" + std::to_string(entry.afterCount);
+    out += ",\"afterSize\":" + std::to_string(entry.afterSize);
+    out += ",\"addedCount\":" + std::to_string(entry.addedCount);
+    out += ",\"addedSize\":" + std::to_string(entry.addedSize);
+    out += ",\"freedCount\":" + std::to_string(entry.freedCount);
+    out += ",\"freedSize\":" + std::to_string(entry.freedSize);
+    out += ",\"survivingCount\":" + std::to_string(entry.survivingCount);
+    out += ",\"survivingSize\":" + std::to_string(entry.survivingSize);
+    out += ",\"countDelta\":" + std::to_string(entry.countDelta());
+    out += ",\"sizeDelta\":" + std::to_string(entry.sizeDelta()) + "}";
+}
+
+// 字段名与ArkTS侧的HeapDiff一致
+std::string formatDiffJson(const HeapDiffResult& diff, const StatsSnapshot& stats, bool withStats) {
+    std::string out = "{\"before\":";
+    appendJsonString(out, diff.before);
+    out += ",\"after\":";
+    appendJsonString(out, diff.after);
+    out += ",\"total\":";
+    appendDiffEntry(out, diff.total);
+    out += ",\"classes\":[";
+    for (size_t i = 0; i < diff.classes.size(); i++) {
+        if (i > 0) {
+            out += ',';
+        }
+        appendDiffEntry(out, diff.classes[i]);
+    }
+    out += "]";
+    if (withStats) {
+        out += ",\"stats\":" + stats.toJson();
+    }
+    out += "}\n";
+    return out;
+}
+
+std::string formatDelta(int64_t delta) {
+    return delta > 0 ? "+" + std::to_string(delta) : std::to_string(delta);
+}
+
+// 文本输出只列出有变化的分组
+std::string formatDiffText(const HeapDiffResult& diff, const StatsSnapshot& stats, bool withStats) {
+    const HeapDiffEntry& total = diff.total;
+    char line[256];
+    std::string out = diff.before + " -> " + diff.after + "\n";
+    snprintf(line, sizeof(line), "objects %llu -> %llu (%s), size %llu -> %llu (%s)\n",
+             static_cast<unsigned long long>(total.beforeCount), static_cast<unsigned long long>(total.afterCount),
+             formatDelta(total.countDelta()).c_str(), static_cast<unsigned long long>(total.beforeSize),
+             static_cast<unsigned long long>(total.afterSize), formatDelta(total.sizeDelta()).c_str());
+    out += line;
+    snprintf(line, sizeof(line), "added %llu (%llu), freed %llu (%llu), surviving %llu (%llu)\n",
+             static_cast<unsigned long long>(total.addedCount), static_cast<unsigned long long>(total.addedSize),
+             static_cast<unsigned long long>(total.freedCount), static_cast<unsigned long long>(total.freedSize),
+             static_cast<unsigned long long>(total.survivingCount),
+             static_cast<unsigned long long>(total.survivingSize));
+    out += line;
+    snprintf(line, sizeof(line), "  %10s %12s %10s %10s %10s  name\n", "count", "size", "added", "freed",
+             "surviving");
+    out += line;
+    for (const HeapDiffEntry& entry : diff.classes) {
+        if (entry.addedCount == 0 && entry.freedCount == 0 && entry.sizeDelta() == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "  %10s %12s %10llu %10llu %10llu  ", formatDelta(entry.countDelta()).c_str(),
+                 formatDelta(entry.sizeDelta()).c_str(), static_cast<unsigned long long>(entry.addedCount),
+                 static_cast<unsigned long long>(entry.freedCount),
+                 static_cast<unsigned long long>(entry.survivingCount));
+        out += line + entry.name + "\n";
+    }
+    if (withStats) {
+        for (const PhaseStats& phase : stats.phases) {
+            snprintf(line, sizeof(line), "  [%s] %.2f ms, %llu items\n", phase.name.c_str(), phase.wallNs / 1e6,
+                     static_cast<unsigned long long>(phase.items));
+            out += line;
+        }
+    }
+    return out;
+}
+
+bool writeOutput(const std::string& path, const std::string& content) {
+    if (path.empty()) {
+        fwrite(content.data(), 1, content.size(), stdout);
+        return true;
+    }
+    FILE* fp = fopen(path.c_str(), "w");
+    if (fp == nullptr) {
+        fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    bool ok = fwrite(content.data(), 1, content.size(), fp) == content.size();
+    return fclose(fp) == 0 && ok;
+}
+
+int runTranslate(const CliOptions& options) {
+    AnalysisMonitor monitor;
+    if (!rawheap_translate::RawHeap::TranslateRawheap(options.inputs[0], options.inputs[1], &monitor,
+                                                      !options.hashIndex)) {
+        fprintf(stderr, "failed to translate %s\n", options.inputs[0].c_str());
+        return 1;
+    }
+    if (options.stats) {
+        fprintf(stderr, "%s\n", monitor.getStats().snapshot("translate").toJson().c_str());
+    }
+    return 0;
+}
+
+int runSummary(const CliOptions& options) {
+    AnalysisMonitor monitor;
+    rawheap_translate::SummaryOptions summaryOptions;
+    if (options.sampleRate > 0) {
+        summaryOptions.sampleRate = options.sampleRate;
+    }
+    for (const HashTarget& target : options.targets) {
+        summaryOptions.hashes.insert(static_cast<uint32_t>(target.second));
+    }
+    rawheap_translate::HeapSummary summary;
+    if (!rawheap_translate::RawHeap::SummarizeRawheap(options.inputs[0], summary, &monitor, summaryOptions)) {
+        fprintf(stderr, "failed to summarize %s\n", options.inputs[0].c_str());
+        return 1;
+    }
+    if (options.stats) {
+        fprintf(stderr, "%s\n", monitor.getStats().snapshot("summary").toJson().c_str());
+    }
+    std::string content = options.format == OutputFormat::JSON
+        ? formatSummaryJson(summary)
+        : formatSummaryText(summary);
+    return writeOutput(options.outputPath, content) ? 0 : 1;
+}
+
+int runDiff(const CliOptions& options) {
+    AnalysisMonitor monitor;
+    HeapDiffOptions diffOptions;
+    diffOptions.useIndex = options.useIndex;
+    HeapDiffResult diff = diffDumps(options.inputs[0], options.inputs[1], diffOptions, &monitor);
+    if (!diff.error.empty()) {
+        fprintf(stderr, "%s\n", diff.error.c_str());
+        return 1;
+    }
+    StatsSnapshot stats = monitor.getStats().snapshot("diff");
+    std::string content = options.format == OutputFormat::JSON
+        ? formatDiffJson(diff, stats, options.stats)
+        : formatDiffText(diff, stats, options.stats);
+    return writeOutput(options.outputPath, content) ? 0 : 1;
+}
+
+int runAnalyze(const CliOptions& options) {
+    // 各dump在工作线程池中并行分析，同时分析的dump受内存预算限制
+    std::vector<DumpAnalysisJob> jobs(options.inputs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        jobs[i].file = options.inputs[i];
+        jobs[i].targets = options.targets;
+    }
+    DumpAnalysisOptions dumpOptions;
+    dumpOptions.maxDepth = options.maxDepth;
+    dumpOptions.useIndex = options.useIndex;
+    dumpOptions.keepSnapshot = options.keepSnapshot;
+    dumpOptions.quickCheck = options.quickCheck;
+    dumpOptions.approximate = options.approximate;
+    if (options.sampleRate > 0) {
+        dumpOptions.sampleRate = options.sampleRate;
+    }
+    dumpOptions.memoryBudget = options.memoryBudget;
+    std::vector<DumpAnalysisResult> results = analyzeDumpBatch(jobs, dumpOptions, nullptr);
+
+    bool failed = false;
+    for (const DumpAnalysisResult& result : results) {
+        failed = failed || !result.error.empty();
+    }
+    std::string content = options.format == OutputFormat::JSON
+        ? formatJson(results, options.stats)
+        : formatText(results, options.targets.size(), options.stats);
+    if (!writeOutput(options.outputPath, content)) {
+        return 1;
+    }
+    return failed ? 2 : 0;
+}
+}
+
+int main(int argc, char** argv) {
+    // 转换器和分析器的Logger写在std::cout上，改写到stderr，stdout只输出结果，可以直接重定向或接管道；
+    // 结果用fwrite写到stdout，不经过std::cout
+    std::cout.rdbuf(std::cerr.rdbuf());
+    CliOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    WorkerPool::instance().configure(options.threads, false);
+    if (options.command == "translate") {
+        return runTranslate(options);
+    }
+    if (options.command == "summary") {
+        return runSummary(options);
+    }
+    if (options.command == "diff") {
+        return runDiff(options);
+    }
+    return runAnalyze(options);
+}
@@ -75,6 +75,7 @@ struct TypeRange {
     JSType objectLast = 0;
 };
 
+// nodes and edges are stored by value, edges refer to their target by node index
 struct Node {
     uint64_t nodeId = 0;
     StringId strId = 1;   // 1: for empty string
@@ -82,7 +83,6 @@ struct Node {
     uint32_t index = 0;
     uint32_t size = 0;
     uint32_t nativeSize = 0;
-    char *data {nullptr};
     NodeType type = DEFAULT_NODETYPE;
     JSType jsType = 0;
 
@@ -90,13 +90,16 @@ struct Node {
 };
 
 struct Edge {
-    Node *to {nullptr};
+    uint32_t to = 0;
     uint32_t nameOrIndex = 0;
     EdgeType type = EdgeType::DEFAULT;
 
-    Edge(Node *node, uint32_t index, EdgeType edgeType) : to(node), nameOrIndex(index), type(edgeType) {}
+    Edge(uint32_t toIndex, uint32_t index, EdgeType edgeType) : to(toIndex), nameOrIndex(index), type(edgeType) {}
 };
 
+static_assert(sizeof(Node) == 32, "Node is stored per object, keep it packed");  // 32: 8-byte id and 6 fields
+static_assert(sizeof(Edge) == 12, "Edge is stored per reference, keep it packed");  // 12: 3 fields of 4 bytes
+
 static constexpr uint8_t ZERO_VALUE = 0x02U;       // 0000 0010
 static constexpr uint8_t HOLE_VALUE = 0x12U;       // 0001 0010
 static constexpr uint8_t NULL_VALUE = 0x22U;       // 0010 0010
@@ -106,5 +109,7 @@ static constexpr uint8_t TRUE_VALUE = 0x52U;       // 0101 0010
 static constexpr uint8_t FALS_VALUE = 0x62U;       // 0110 0010
 static constexpr uint8_t INTL_VALUE = 0x04U;       // 0000 0100
 static constexpr uint8_t DOUB_VALUE = 0x06U;       // 0000 0110
+
+static constexpr size_t PROGRESS_MASK = 0xFFF;  // check progress and cancellation every 4096 nodes
 }  // namespace rawheap_translate
 #endif  // RAWHEAP_TRANSLATE_COMMON_H
\ No newline at end of file
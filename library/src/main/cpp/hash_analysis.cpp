@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hash_analysis.h"
+#include "rawheap_translate.h"
+#include "worker_pool.h"
+
+const char* const ANALYSIS_CANCELED = "分析已取消";
+
+namespace {
+// 分析时的峰值内存与文件大小之比(经验值)：rawheap转换时节点、边和输出的快照同时在内存中，
+// 快照解析后保留CSR图和字符串表
+const size_t RAWHEAP_MEMORY_FACTOR = 6;
+const size_t SNAPSHOT_MEMORY_FACTOR = 3;
+const size_t DEFAULT_BUDGET_DIVISOR = 4;
+
+bool endsWith(const std::string& value, const char* suffix) {
+    size_t length = strlen(suffix);
+    return value.size() >= length && value.compare(value.size() - length, length, suffix) == 0;
+}
+
+size_t defaultMemoryBudget() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return static_cast<size_t>(1) << 30;
+    }
+    return static_cast<size_t>(pages) * static_cast<size_t>(pageSize) / DEFAULT_BUDGET_DIVISOR;
+}
+}
+
+std::vector<NodeRef> analyzeHashTargets(TaskHeapSnapshot& task, const std::vector<HashTarget>& targets,
+                                        int maxDepth, AnalysisMonitor* monitor, const NodeRefCallback& onResult) {
+    // 各目标的查询互不依赖，在工作线程池中并行执行，结果按输入顺序收集
+    size_t targetCount = targets.size();
+    std::vector<NodeRef> found(targetCount);
+    std::vector<uint8_t> hit(targetCount, 0);
+    std::atomic<size_t> completed(0);
+    WorkerPool::instance().parallelFor(0, targetCount, 1, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; i++) {
+            if (monitor != nullptr && monitor->isCancelled()) {
+                return;
+            }
+            const HashTarget& target = targets[i];
+            std::string nodeName = "Int:" + std::to_string(target.second);
+            std::vector<ReferenceChain> refChains = task.getShortestPathToGCRootByName(nodeName, maxDepth, monitor);
+
+            if (!refChains.empty()) {
+                NodeRef& nodeRef = found[i];
+                nodeRef.hash = target.second;
+                nodeRef.name = target.first;
+                nodeRef.refs = std::move(refChains);
+                // 保留大小要等整个快照的支配树算完，先不取，流式结果不被它拖住
+                RetainedInfo retainedInfo;
+                if (task.getRetainedInfoByName(nodeName, retainedInfo, false)) {
+                    nodeRef.selfSize = retainedInfo.self_size;
+                }
+                hit[i] = 1;
+                // 先把这个目标交给调用方，不必等整批查询结束
+                if (onResult) {
+                    onResult(nodeRef);
+                }
+            }
+            if (monitor != nullptr) {
+                monitor->report("query", 0, 0, completed.fetch_add(1) + 1, 0);
+            }
+        }
+    });
+
+    // 所有引用链都已推送后再计算支配树，补上保留大小；取消后不再计算
+    std::vector<NodeRef> result;
+    bool withRetained = std::find(hit.begin(), hit.end(), 1) != hit.end() &&
+                        (monitor == nullptr || !monitor->isCancelled());
+    if (withRetained) {
+        task.computeDominatorTree(monitor);
+    }
+    for (size_t i = 0; i < targetCount; i++) {
+        if (hit[i]) {
+            RetainedInfo retainedInfo;
+            if (withRetained &&
+                task.getRetainedInfoByName("Int:" + std::to_string(targets[i].second), retainedInfo)) {
+                found[i].retainedSize = retainedInfo.retained_size;
+            }
+            result.push_back(std::move(found[i]));
+        }
+    }
+    return result;
+}
+
+bool filterPresentTargets(const std::string& rawheapPath, const std::vector<HashTarget>& targets,
+                          std::vector<HashTarget>& present, AnalysisMonitor* monitor) {
+    std::unordered_set<uint32_t> hashes;
+    for (const HashTarget& target : targets) {
+        hashes.insert(static_cast<uint32_t>(target.second));
+    }
+    std::unordered_set<uint32_t> found;
+    if (!rawheap_translate::RawHeap::ScanHashes(rawheapPath, hashes, found, monitor)) {
+        return false;
+    }
+    present.clear();
+    for (const HashTarget& target : targets) {
+        if (found.count(static_cast<uint32_t>(target.second)) != 0) {
+            present.push_back(target);
+        }
+    }
+    return true;
+}
+
+bool approximateRawheap(const std::string& rawheapPath, const std::vector<HashTarget>& targets, double sampleRate,
+                        DumpAnalysisResult& result, AnalysisMonitor* monitor) {
+    rawheap_translate::SummaryOptions options;
+    options.sampleRate = sampleRate;
+    for (const HashTarget& target : targets) {
+        options.hashes.insert(static_cast<uint32_t>(target.second));
+    }
+    if (!rawheap_translate::RawHeap::SummarizeRawheap(rawheapPath, result.summary, monitor, options)) {
+        return false;
+    }
+    // 目标按输入顺序输出，同一hash的多个对象取第一个
+    std::unordered_map<uint32_t, const rawheap_translate::SummaryTarget*> found;
+    for (const rawheap_translate::SummaryTarget& item : result.summary.targets) {
+        found.emplace(item.hash, &item);
+    }
+    for (const HashTarget& target : targets) {
+        auto it = found.find(static_cast<uint32_t>(target.second));
+        if (it == found.end()) {
+            continue;
+        }
+        NodeRef nodeRef;
+        nodeRef.hash = target.second;
+        nodeRef.name = target.first;
+        nodeRef.selfSize = it->second->selfSize + it->second->nativeSize;
+        result.refs.push_back(std::move(nodeRef));
+    }
+    return true;
+}
+
+std::string snapshotPathForRawheap(const std::string& rawheapPath) {
+    std::string heapsnapshotFile = rawheapPath;
+    size_t pos = heapsnapshotFile.rfind(".rawheap");
+    if (pos != std::string::npos) {
+        heapsnapshotFile.replace(pos, 8, ".heapsnapshot");
+    } else {
+        heapsnapshotFile += ".heapsnapshot";   // 不能覆盖输入文件
+    }
+    return heapsnapshotFile;
+}
+
+size_t estimateDumpMemory(const std::string& file) {
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) {
+        return 0;
+    }
+    size_t factor = endsWith(file, ".rawheap") ? RAWHEAP_MEMORY_FACTOR : SNAPSHOT_MEMORY_FACTOR;
+    return static_cast<size_t>(st.st_size) * factor;
+}
+
+DumpAnalysisResult analyzeDump(const DumpAnalysisJob& job, const DumpAnalysisOptions& options,
+                               AnalysisMonitor* monitor) {
+    DumpAnalysisResult result;
+    result.file = job.file;
+    std::string snapshotPath = job.file;
+    bool translated = false;
+    bool useIndex = options.useIndex;
+    const std::vector<HashTarget>* targets = &job.targets;
+    std::vector<HashTarget> present;
+    if (endsWith(job.file, ".rawheap") && options.approximate) {
+        if (!approximateRawheap(job.file, job.targets, options.sampleRate, result, monitor)) {
+            result.error = monitor != nullptr && monitor->isCancelled() ? ANALYSIS_CANCELED : "统计rawheap失败";
+        }
+        return result;
+    }
+    if (endsWith(job.file, ".rawheap")) {
+        // 快速检查：目标都不在dump中时不必转换；扫描失败时按完整流程处理，由转换给出错误
+        if (options.quickCheck && filterPresentTargets(job.file, job.targets, present, monitor)) {
+            if (present.empty()) {
+                return result;
+            }
+            targets = &present;
+        }
+        // 临时转换出的快照用完即删，不写sidecar索引；加序号避免同一个文件同时分析时互相覆盖
+        snapshotPath = snapshotPathForRawheap(job.file);
+        if (!options.keepSnapshot) {
+            static std::atomic<uint32_t> tempSequence(0);
+            size_t pos = snapshotPath.rfind(".heapsnapshot");
+            snapshotPath.insert(pos, "." + std::to_string(tempSequence.fetch_add(1)));
+        }
+        // 快照只供分析使用，hash写入索引而不生成数值节点
+        if (!rawheap_translate::RawHeap::TranslateRawheap(job.file, snapshotPath, monitor, false)) {
+            remove(snapshotPath.c_str());
+            result.error = monitor != nullptr && monitor->isCancelled() ? ANALYSIS_CANCELED : "转换rawheap失败";
+            return result;
+        }
+        translated = true;
+        useIndex = false;
+    }
+
+    {
+        TaskHeapSnapshot task(snapshotPath, useIndex);
+        if (task.parseSnapshot(monitor)) {
+            result.refs = analyzeHashTargets(task, *targets, options.maxDepth, monitor);
+        } else {
+            result.error = "解析快照失败";
+        }
+    }
+    if (monitor != nullptr && monitor->isCancelled()) {
+        result.error = ANALYSIS_CANCELED;
+    }
+    if (translated && !options.keepSnapshot) {
+        remove(snapshotPath.c_str());
+    }
+    return result;
+}
+
+std::vector<DumpAnalysisResult> analyzeDumpBatch(const std::vector<DumpAnalysisJob>& jobs,
+                                                 const DumpAnalysisOptions& options, AnalysisMonitor* monitor,
+                                                 const DumpResultCallback& onDump) {
+    std::vector<DumpAnalysisResult> results(jobs.size());
+    size_t budget = options.memoryBudget > 0 ? options.memoryBudget : defaultMemoryBudget();
+    CancelFlag cancelFlag = monitor != nullptr ? monitor->getCancelFlag() : nullptr;
+    std::mutex mutex;
+    std::condition_variable released;
+    size_t reserved = 0;
+    size_t running = 0;
+    std::atomic<size_t> completed(0);
+
+    TaskGroup group(WorkerPool::instance());
+    auto cancelled = [monitor]() { return monitor != nullptr && monitor->isCancelled(); };
+    for (size_t i = 0; i < jobs.size(); i++) {
+        // 单个超出预算的dump在没有其他dump运行时独占执行
+        size_t need = std::min(estimateDumpMemory(jobs[i].file), budget);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            released.wait(lock, [&]() { return reserved + need <= budget || running == 0 || cancelled(); });
+            if (cancelled()) {
+                break;
+            }
+            reserved += need;
+            running++;
+        }
+        group.run([&, i, need]() {
+            // 每个dump用自己的monitor统计，结束后汇总；进度只上报已完成的dump数
+            AnalysisMonitor dumpMonitor(cancelFlag);
+            DumpAnalysisResult& result = results[i];
+            try {
+                result = analyzeDump(jobs[i], options, &dumpMonitor);
+            } catch (const std::exception& e) {
+                result.file = jobs[i].file;
+                result.error = e.what();
+            } catch (...) {
+                result.file = jobs[i].file;
+                result.error = "未知错误";
+            }
+            result.stats = dumpMonitor.getStats().snapshot(jobs[i].file);
+            if (monitor != nullptr) {
+                monitor->getStats().merge(result.stats.phases);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                reserved -= need;
+                running--;
+            }
+            released.notify_all();
+            if (onDump) {
+                onDump(i, result);
+            }
+            if (monitor != nullptr) {
+                monitor->report("batch", 0, 0, completed.fetch_add(1) + 1, 0);
+            }
+        });
+    }
+    group.wait();
+
+    // 取消后未开始的dump也给出结果，保证与jobs一一对应
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (results[i].file.empty()) {
+            results[i].file = jobs[i].file;
+            results[i].error = ANALYSIS_CANCELED;
+        }
+    }
+    return results;
+}
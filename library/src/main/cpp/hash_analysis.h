@@ -0,0 +1,86 @@
+#ifndef HASH_ANALYSIS_H
+#define HASH_ANALYSIS_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "heap_snapshot_parser.h"
+#include "rawheap_translate.h"
+
+// 单个目标的查询结果
+struct NodeRef {
+    int hash;
+    std::string name;
+    std::vector<ReferenceChain> refs;
+    uint64_t selfSize = 0;
+    uint64_t retainedSize = 0;
+};
+
+// 查询目标：名称和对象hash
+using HashTarget = std::pair<std::string, int>;
+using NodeRefCallback = std::function<void(const NodeRef& nodeRef)>;
+
+// 在工作线程池中并行查询各目标到GC根的最短引用链，结果按输入顺序返回，没有引用链的目标不在结果中；
+// onResult在找到引用链的工作线程中调用，可能并发，此时还没有计算支配树，retainedSize为0；
+// 全部引用链找到后才计算支配树(dominators阶段)，返回的结果带有retainedSize；monitor取消后返回已找到的部分
+std::vector<NodeRef> analyzeHashTargets(TaskHeapSnapshot& task, const std::vector<HashTarget>& targets,
+                                        int maxDepth, AnalysisMonitor* monitor,
+                                        const NodeRefCallback& onResult = nullptr);
+
+// 取消后返回的错误信息
+extern const char* const ANALYSIS_CANCELED;
+
+// 一个dump文件及其查询目标，文件为.rawheap时先转换为快照
+struct DumpAnalysisJob {
+    std::string file;
+    std::vector<HashTarget> targets;
+};
+
+struct DumpAnalysisResult {
+    std::string file;
+    std::string error;           // 为空表示成功
+    std::vector<NodeRef> refs;
+    StatsSnapshot stats;
+    rawheap_translate::HeapSummary summary;  // approximate时的对象统计
+};
+
+struct DumpAnalysisOptions {
+    int maxDepth = 10;
+    bool useIndex = false;       // .heapsnapshot输入是否加载/写入sidecar索引
+    bool keepSnapshot = false;   // 是否保留rawheap转换出的快照
+    size_t memoryBudget = 0;     // 同时分析的dump预计内存之和的上限(字节)，为0时为物理内存的1/4
+    bool quickCheck = false;     // .rawheap输入先扫描对象表，只转换和查询其中存在的目标
+    // .rawheap输入不转换快照，只给出对象统计和各目标的精确大小，目标没有引用链和保留大小；.heapsnapshot输入不受影响
+    bool approximate = false;
+    // approximate时对象的抽样比例，默认统计全部对象：省下的时间主要来自不转换快照，抽样只在V2格式上明显加快读表
+    double sampleRate = 1.0;
+};
+
+using DumpResultCallback = std::function<void(size_t index, const DumpAnalysisResult& result)>;
+
+// 分析单个dump，monitor的统计中包含转换、解析和查询各阶段
+DumpAnalysisResult analyzeDump(const DumpAnalysisJob& job, const DumpAnalysisOptions& options,
+                               AnalysisMonitor* monitor);
+
+// 在工作线程池中并行分析多个dump，预计内存超出预算时等已有的dump完成后再开始下一个；
+// 结果与jobs一一对应，单个dump失败不影响其他dump；onDump在该dump完成的工作线程中调用
+std::vector<DumpAnalysisResult> analyzeDumpBatch(const std::vector<DumpAnalysisJob>& jobs,
+                                                 const DumpAnalysisOptions& options, AnalysisMonitor* monitor,
+                                                 const DumpResultCallback& onDump = nullptr);
+
+// 近似分析rawheap：按sampleRate统计对象，targets中存在的目标给出精确的自身大小，refs为空
+bool approximateRawheap(const std::string& rawheapPath, const std::vector<HashTarget>& targets, double sampleRate,
+                        DumpAnalysisResult& result, AnalysisMonitor* monitor);
+
+// 只扫描rawheap对象表，返回targets中在dump里存在的目标；扫描失败时返回false
+bool filterPresentTargets(const std::string& rawheapPath, const std::vector<HashTarget>& targets,
+                          std::vector<HashTarget>& present, AnalysisMonitor* monitor);
+
+// 按文件大小估算分析一个dump的峰值内存
+size_t estimateDumpMemory(const std::string& file);
+
+// rawheap转换出的快照路径：把扩展名.rawheap替换为.heapsnapshot
+std::string snapshotPathForRawheap(const std::string& rawheapPath);
+
+#endif // HASH_ANALYSIS_H
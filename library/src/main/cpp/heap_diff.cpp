@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include "heap_diff.h"
+#include "hash_analysis.h"
+#include "heap_snapshot_parser.h"
+#include "worker_pool.h"
+
+namespace {
+// 归并时每处理这么多对象检查一次取消并上报进度
+const size_t DIFF_CHECK_MASK = (1u << 16) - 1;
+
+bool endsWith(const std::string& value, const char* suffix) {
+    size_t length = strlen(suffix);
+    return value.size() >= length && value.compare(value.size() - length, length, suffix) == 0;
+}
+
+bool loadObjects(const std::string& file, bool useIndex, rawheap_translate::HeapObjects& objects,
+                 AnalysisMonitor* monitor) {
+    if (endsWith(file, ".rawheap")) {
+        return rawheap_translate::RawHeap::CollectRawheapObjects(file, objects, monitor);
+    }
+    TaskHeapSnapshot task(file, useIndex);
+    if (!task.parseSnapshot(monitor)) {
+        return false;
+    }
+    task.collectObjects(objects);
+    return true;
+}
+
+// 把一个dump的分组序号映射为结果中的分组序号，同名分组合并
+std::vector<uint32_t> mapClasses(const std::vector<std::string>& classNames,
+                                 std::unordered_map<std::string, uint32_t>& indexByName,
+                                 std::vector<HeapDiffEntry>& entries) {
+    std::vector<uint32_t> mapping(classNames.size());
+    for (size_t i = 0; i < classNames.size(); i++) {
+        auto inserted = indexByName.emplace(classNames[i], static_cast<uint32_t>(entries.size()));
+        if (inserted.second) {
+            entries.emplace_back();
+            entries.back().name = classNames[i];
+        }
+        mapping[i] = inserted.first->second;
+    }
+    return mapping;
+}
+
+uint64_t absDelta(int64_t delta) {
+    return delta < 0 ? static_cast<uint64_t>(-delta) : static_cast<uint64_t>(delta);
+}
+}
+
+bool diffHeapObjects(const rawheap_translate::HeapObjects& before, const rawheap_translate::HeapObjects& after,
+                     HeapDiffResult& result, AnalysisMonitor* monitor) {
+    std::unordered_map<std::string, uint32_t> indexByName;
+    std::vector<HeapDiffEntry> entries;
+    std::vector<uint32_t> beforeClasses = mapClasses(before.classNames, indexByName, entries);
+    std::vector<uint32_t> afterClasses = mapClasses(after.classNames, indexByName, entries);
+
+    // 两边都按id升序，一次归并即可区分释放、新增和存活的对象
+    const std::vector<rawheap_translate::HeapObject>& oldObjects = before.objects;
+    const std::vector<rawheap_translate::HeapObject>& newObjects = after.objects;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < oldObjects.size() || j < newObjects.size()) {
+        if (((i + j) & DIFF_CHECK_MASK) == 0 && monitor != nullptr &&
+            !monitor->report("diff", 0, 0, i + j, 0)) {
+            return false;
+        }
+        if (j == newObjects.size() || (i < oldObjects.size() && oldObjects[i].id < newObjects[j].id)) {
+            HeapDiffEntry& entry = entries[beforeClasses[oldObjects[i].classIndex]];
+            entry.beforeCount++;
+            entry.beforeSize += oldObjects[i].size;
+            entry.freedCount++;
+            entry.freedSize += oldObjects[i].size;
+            i++;
+        } else if (i == oldObjects.size() || newObjects[j].id < oldObjects[i].id) {
+            HeapDiffEntry& entry = entries[afterClasses[newObjects[j].classIndex]];
+            entry.afterCount++;
+            entry.afterSize += newObjects[j].size;
+            entry.addedCount++;
+            entry.addedSize += newObjects[j].size;
+            j++;
+        } else {
+            HeapDiffEntry& oldEntry = entries[beforeClasses[oldObjects[i].classIndex]];
+            oldEntry.beforeCount++;
+            oldEntry.beforeSize += oldObjects[i].size;
+            HeapDiffEntry& newEntry = entries[afterClasses[newObjects[j].classIndex]];
+            newEntry.afterCount++;
+            newEntry.afterSize += newObjects[j].size;
+            newEntry.survivingCount++;
+            newEntry.survivingSize += newObjects[j].size;
+            i++;
+            j++;
+        }
+    }
+
+    result.total = HeapDiffEntry();
+    for (const HeapDiffEntry& entry : entries) {
+        result.total.beforeCount += entry.beforeCount;
+        result.total.beforeSize += entry.beforeSize;
+        result.total.afterCount += entry.afterCount;
+        result.total.afterSize += entry.afterSize;
+        result.total.addedCount += entry.addedCount;
+        result.total.addedSize += entry.addedSize;
+        result.total.freedCount += entry.freedCount;
+        result.total.freedSize += entry.freedSize;
+        result.total.survivingCount += entry.survivingCount;
+        result.total.survivingSize += entry.survivingSize;
+    }
+    std::sort(entries.begin(), entries.end(), [](const HeapDiffEntry& a, const HeapDiffEntry& b) {
+        uint64_t sizeA = absDelta(a.sizeDelta());
+        uint64_t sizeB = absDelta(b.sizeDelta());
+        if (sizeA != sizeB) {
+            return sizeA > sizeB;
+        }
+        uint64_t countA = absDelta(a.countDelta());
+        uint64_t countB = absDelta(b.countDelta());
+        return countA != countB ? countA > countB : a.name < b.name;
+    });
+    result.classes = std::move(entries);
+    return true;
+}
+
+HeapDiffResult diffDumps(const std::string& before, const std::string& after, const HeapDiffOptions& options,
+                         AnalysisMonitor* monitor) {
+    HeapDiffResult result;
+    result.before = before;
+    result.after = after;
+
+    // 两个dump互不依赖，各用自己的monitor并行读取，结束后汇总统计
+    const std::string* files[2] = {&before, &after};
+    rawheap_translate::HeapObjects objects[2];
+    bool loaded[2] = {false, false};
+    CancelFlag cancelFlag = monitor != nullptr ? monitor->getCancelFlag() : nullptr;
+    {
+        TaskGroup group(WorkerPool::instance());
+        for (int k = 0; k < 2; k++) {
+            group.run([&, k]() {
+                AnalysisMonitor dumpMonitor(cancelFlag);
+                loaded[k] = loadObjects(*files[k], options.useIndex, objects[k], &dumpMonitor);
+                if (monitor != nullptr) {
+                    monitor->getStats().merge(dumpMonitor.getStats().snapshot(*files[k]).phases);
+                }
+            });
+        }
+        group.wait();
+    }
+    if (monitor != nullptr && monitor->isCancelled()) {
+        result.error = ANALYSIS_CANCELED;
+        return result;
+    }
+    for (int k = 0; k < 2; k++) {
+        if (!loaded[k]) {
+            result.error = "读取dump失败: " + *files[k];
+            return result;
+        }
+    }
+
+    ScopedPhase diffPhase(monitor, "diff");
+    if (!diffHeapObjects(objects[0], objects[1], result, monitor)) {
+        result.error = ANALYSIS_CANCELED;
+        return result;
+    }
+    diffPhase.addCounts(objects[0].objects.size() + objects[1].objects.size(), 0);
+    return result;
+}
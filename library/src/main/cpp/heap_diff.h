@@ -0,0 +1,50 @@
+#ifndef HEAP_DIFF_H
+#define HEAP_DIFF_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "analysis_monitor.h"
+#include "rawheap_translate.h"
+
+// 一个分组(构造函数名或类型)在两个dump之间的变化，大小为self_size + native_size
+struct HeapDiffEntry {
+    std::string name;
+    uint64_t beforeCount = 0;
+    uint64_t beforeSize = 0;
+    uint64_t afterCount = 0;
+    uint64_t afterSize = 0;
+    uint64_t addedCount = 0;       // 只在after中出现的对象
+    uint64_t addedSize = 0;
+    uint64_t freedCount = 0;       // 只在before中出现的对象
+    uint64_t freedSize = 0;
+    uint64_t survivingCount = 0;   // 两个dump中都存在的对象，按after中的分组统计
+    uint64_t survivingSize = 0;    // 在after中的大小
+
+    int64_t countDelta() const { return static_cast<int64_t>(afterCount - beforeCount); }
+    int64_t sizeDelta() const { return static_cast<int64_t>(afterSize - beforeSize); }
+};
+
+struct HeapDiffResult {
+    std::string before;
+    std::string after;
+    std::string error;                   // 为空表示成功
+    HeapDiffEntry total;
+    std::vector<HeapDiffEntry> classes;  // 按大小变化的绝对值降序
+};
+
+struct HeapDiffOptions {
+    bool useIndex = false;  // .heapsnapshot输入是否加载/写入sidecar索引
+};
+
+// 按对象id比较两组已按id排序的对象，一次线性归并得出新增、释放和存活的对象；
+// 分组按名称对应，monitor取消后返回false
+bool diffHeapObjects(const rawheap_translate::HeapObjects& before, const rawheap_translate::HeapObjects& after,
+                     HeapDiffResult& result, AnalysisMonitor* monitor = nullptr);
+
+// 比较同一进程先后的两个dump(.rawheap或.heapsnapshot，可以混用，分组名相同)，对象id在同一进程的dump之间保持不变；
+// 两个dump在工作线程池中并行读取，rawheap只读对象表和字符串表，不转换快照
+HeapDiffResult diffDumps(const std::string& before, const std::string& after, const HeapDiffOptions& options,
+                         AnalysisMonitor* monitor);
+
+#endif // HEAP_DIFF_H
@@ -3,16 +3,20 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <sstream>
-#include <queue>
 #include <regex>
 #include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
 // 替换jsoncpp为rapidjson，使用SAX方式处理大文件
 #include "rapidjson/reader.h"
 #include "rapidjson/filereadstream.h"
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 #include "heap_snapshot_parser.h"
+#include "rawheap_translate.h"
 
 // 定义GC根类型的检查
 bool isGCRoot(const std::string& nodeType, const std::string& nodeName) {
@@ -24,6 +28,15 @@ bool isGCRoot(const std::string& nodeType, const std::string& nodeName) {
            nodeName.find("(V8 internal)") == 0;
 }
 
+bool isGCRoot(HeapNodeType nodeType, const std::string& nodeName) {
+    return nodeType == HeapNodeType::SYNTHETIC ||
+           nodeType == HeapNodeType::HIDDEN ||
+           nodeName == "(GC root)" ||
+           nodeName == "(root)" ||
+           nodeName == "(global)" ||
+           nodeName.find("(V8 internal)") == 0;
+}
+
 // 边类型映射函数
 std::string mapEdgeType(int typeCode) {
     switch (typeCode) {
@@ -38,6 +51,10 @@ std::string mapEdgeType(int typeCode) {
     }
 }
 
+std::string mapEdgeType(HeapEdgeType type) {
+    return mapEdgeType(static_cast<int>(type));
+}
+
 // 节点类型映射函数 ["hidden","array","string","object","code","closure","regexp","number","native","synthetic","concatenated string","slicedstring","symbol","bigint","framework"]
 std::string mapNodeType(int typeCode) {
     switch (typeCode) {
@@ -60,8 +77,26 @@ std::string mapNodeType(int typeCode) {
     }
 }
 
+std::string mapNodeType(HeapNodeType type) {
+    return mapNodeType(static_cast<int>(type));
+}
+
+static HeapNodeType toNodeType(int typeCode) {
+    if (typeCode < 0 || typeCode >= static_cast<int>(HeapNodeType::UNKNOWN)) {
+        return HeapNodeType::UNKNOWN;
+    }
+    return static_cast<HeapNodeType>(typeCode);
+}
+
+static HeapEdgeType toEdgeType(int typeCode) {
+    if (typeCode < 0 || typeCode >= static_cast<int>(HeapEdgeType::UNKNOWN)) {
+        return HeapEdgeType::UNKNOWN;
+    }
+    return static_cast<HeapEdgeType>(typeCode);
+}
+
 // 解析节点名称和路径信息
-void TaskHeapSnapshot::parseNodeNameAndPath(HeapNode& node, const std::string& originalName) {
+void TaskHeapSnapshot::parseNodeNameAndPath(ReferenceChainNode& node, const std::string& originalName) const {
     if (originalName.find("#") != std::string::npos && originalName[0] != '#' && originalName[0] != '=') {
         size_t hashPos = originalName.find("#");
         node.path = originalName.substr(0, hashPos);
@@ -82,9 +117,6 @@ void TaskHeapSnapshot::parseNodeNameAndPath(HeapNode& node, const std::string& o
                 } catch (...) {
                     node.line = 0;
                 }
-                
-                // 提取模块部分
-                node.module = namePart.substr(lineEnd + 1);
             } else {
                 node.name = namePart;
             }
@@ -96,20 +128,45 @@ void TaskHeapSnapshot::parseNodeNameAndPath(HeapNode& node, const std::string& o
     }
 }
 
+// 生成引用链节点，此时才解析名称
+ReferenceChainNode TaskHeapSnapshot::makeChainNode(int nodeIndex) const {
+    const HeapNode& heapNode = nodes[nodeIndex];
+    ReferenceChainNode chainNode(heapNode.id, "", mapNodeType(heapNode.type));
+    parseNodeNameAndPath(chainNode, getStringById(heapNode.name_id));
+    return chainNode;
+}
+
 // 获取字符串
 std::string TaskHeapSnapshot::getStringById(int id) const {
-    if (id >= 0 && id < static_cast<int>(strings.size())) {
-        return strings[id];
+    if (id >= 0 && id + 1 < static_cast<int>(stringOffsets.size())) {
+        return std::string(stringData.data() + stringOffsets[id], stringOffsets[id + 1] - stringOffsets[id]);
     }
     return "";
 }
 
+bool TaskHeapSnapshot::stringEquals(int id, const char* str, size_t length) const {
+    return stringOffsets[id + 1] - stringOffsets[id] == length &&
+           memcmp(stringData.data() + stringOffsets[id], str, length) == 0;
+}
+
+// 查找字符串索引，不存在时返回-1
+int TaskHeapSnapshot::findStringId(const std::string& str) const {
+    int stringCount = static_cast<int>(stringOffsets.size()) - 1;
+    for (int i = 0; i < stringCount; i++) {
+        if (stringEquals(i, str.data(), str.size())) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 // SAX解析处理器
 class TaskHeapSnapshotHandler {
 private:
     std::vector<std::string>& strings;
-    std::vector<int>& nodesRaw;
+    std::vector<int64_t>& nodesRaw;
     std::vector<int>& edgesRaw;
+    std::vector<int64_t>& hashIndexRaw;
     TaskHeapSnapshot::Meta& meta;
     
     enum ParseState {
@@ -117,6 +174,7 @@ private:
         InStrings,
         InNodes,
         InEdges,
+        InHashIndex,
         InMeta,
         InNodeFields,
         InNodeTypes,
@@ -127,11 +185,34 @@ private:
     ParseState currentState;
     int arrayIndex;
     
+    // 进度上报与取消检查
+    AnalysisMonitor* monitor;
+    const rapidjson::FileReadStream* stream;
+    uint64_t totalBytes;
+    uint64_t valueCount;
+    
+    // 每解析一定数量的节点/边数值检查一次，返回false时SAX解析中止
+    bool checkProgress() {
+        if (monitor == nullptr || (++valueCount & 0xFFFF) != 0) {
+            return true;
+        }
+        size_t nodeFieldCount = meta.node_fields.empty() ? 1 : meta.node_fields.size();
+        size_t edgeFieldCount = meta.edge_fields.empty() ? 1 : meta.edge_fields.size();
+        return monitor->report("parse", stream->Tell(), totalBytes, nodesRaw.size() / nodeFieldCount,
+                               edgesRaw.size() / edgeFieldCount);
+    }
+    
 public:
-    TaskHeapSnapshotHandler(std::vector<std::string>& s, std::vector<int>& nodesR, 
-                          std::vector<int>& edgesR, TaskHeapSnapshot::Meta& m)
-        : strings(s), nodesRaw(nodesR), edgesRaw(edgesR), meta(m),
-          currentState(None), arrayIndex(0) {}
+    TaskHeapSnapshotHandler(std::vector<std::string>& s, std::vector<int64_t>& nodesR, 
+                          std::vector<int>& edgesR, std::vector<int64_t>& hashIndexR, TaskHeapSnapshot::Meta& m)
+        : strings(s), nodesRaw(nodesR), edgesRaw(edgesR), hashIndexRaw(hashIndexR), meta(m),
+          currentState(None), arrayIndex(0), monitor(nullptr), stream(nullptr), totalBytes(0), valueCount(0) {}
+    
+    void setMonitor(AnalysisMonitor* monitor_, const rapidjson::FileReadStream* stream_, uint64_t totalBytes_) {
+        monitor = monitor_;
+        stream = stream_;
+        totalBytes = totalBytes_;
+    }
     
     // 获取字符串的辅助函数
     std::string getStringById(int id) const {
@@ -155,6 +236,15 @@ public:
     }
     
     bool Int(int i) {
+        return Int64(i);
+    }
+    
+    bool Uint(unsigned u) { 
+        return Int64(u);
+    }
+    
+    // 节点数据保留完整的64位值（id可能超过int范围），其余字段按int处理
+    bool Int64(int64_t i) {
         switch (currentState) {
         case InStrings:
             if (arrayIndex >= (int)strings.size()) {
@@ -163,9 +253,14 @@ public:
             break;
         case InNodes:
             nodesRaw.push_back(i);
-            break;
+            arrayIndex++;
+            return checkProgress();
         case InEdges:
-            edgesRaw.push_back(i);
+            edgesRaw.push_back(static_cast<int>(i));
+            arrayIndex++;
+            return checkProgress();
+        case InHashIndex:
+            hashIndexRaw.push_back(i);
             break;
         case InNodeTypes:
             if (arrayIndex % 2 == 0) {
@@ -192,19 +287,9 @@ public:
         return true;
     }
     
-    bool Uint(unsigned u) { 
-        Int(static_cast<int>(u)); 
-        return true; 
-    }
-    
-    bool Int64(int64_t i) { 
-        Int(static_cast<int>(i)); 
-        return true; 
-    } 
-    
     bool Uint64(uint64_t u) { 
-        Int(static_cast<int>(u)); 
-        return true; 
+        // 保留位模式，id在使用时按uint64_t解释
+        return Int64(static_cast<int64_t>(u));
     }
     
     bool Double(double d) { 
@@ -238,13 +323,15 @@ public:
         
         std::string numStr(str, length);
         try {
-            int value = std::stoi(numStr);
             switch (currentState) {
             case InNodes:
-                nodesRaw.push_back(value);
+                nodesRaw.push_back(static_cast<int64_t>(std::stoull(numStr)));
                 break;
             case InEdges:
-                edgesRaw.push_back(value);
+                edgesRaw.push_back(std::stoi(numStr));
+                break;
+            case InHashIndex:
+                hashIndexRaw.push_back(std::stoll(numStr));
                 break;
             }
         } catch (...) {
@@ -272,6 +359,9 @@ public:
         } else if (key == "edges") {
             currentState = InEdges;
             arrayIndex = 0;
+        } else if (key == "ark_hash_index") {
+            currentState = InHashIndex;
+            arrayIndex = 0;
         } else if (key == "node_fields") {
             currentState = InNodeFields;
             arrayIndex = 0;
@@ -313,8 +403,162 @@ public:
     }
 };
 
-// 解析快照文件
-bool TaskHeapSnapshot::parseSnapshot() {
+// 加载快照：优先使用与快照大小、修改时间一致的sidecar索引，否则解析JSON并写入索引
+bool TaskHeapSnapshot::parseSnapshot(AnalysisMonitor* monitor) {
+    if (useIndex) {
+        ScopedPhase phase(monitor, "index_load");
+        if (loadIndex()) {
+            phase.addCounts(nodes.size() + edges.size(), indexReader->mappedSize());
+            return true;
+        }
+    }
+    if (!parseJson(monitor)) {
+        return false;
+    }
+    if (useIndex) {
+        ScopedPhase phase(monitor, "index_save");
+        saveIndex();
+    }
+    return true;
+}
+
+// 从sidecar索引映射各数组，索引缺失、过期或不完整时返回false
+bool TaskHeapSnapshot::loadIndex() {
+    SnapshotFileStamp stamp;
+    if (!SnapshotFileStamp::read(path, stamp)) {
+        return false;
+    }
+    std::unique_ptr<SnapshotIndexReader> reader = std::make_unique<SnapshotIndexReader>();
+    if (!reader->open(getSnapshotIndexPath(path), stamp)) {
+        return false;
+    }
+    bool ok = reader->mapSection(IndexSection::NODES, nodes) &&
+              reader->mapSection(IndexSection::EDGES, edges) &&
+              reader->mapSection(IndexSection::FIRST_EDGE_INDEXES, firstEdgeIndexes) &&
+              reader->mapSection(IndexSection::FIRST_RETAINER_INDEXES, firstRetainerIndexes) &&
+              reader->mapSection(IndexSection::RETAINING_NODES, retainingNodes) &&
+              reader->mapSection(IndexSection::RETAINING_EDGES, retainingEdges) &&
+              reader->mapSection(IndexSection::GC_ROOT_FLAGS, gcRootFlags) &&
+              reader->mapSection(IndexSection::NODE_ID_INDEX, nodeIdIndex) &&
+              reader->mapSection(IndexSection::STRING_OFFSETS, stringOffsets) &&
+              reader->mapSection(IndexSection::STRING_DATA, stringData) &&
+              reader->mapSection(IndexSection::HASH_INDEX, hashIndex) &&
+              reader->mapSection(IndexSection::ROOT_DISTANCES, rootDistances);
+    size_t nodeCount = nodes.size();
+    ok = ok && firstEdgeIndexes.size() == nodeCount + 1 && firstRetainerIndexes.size() == nodeCount + 1 &&
+         gcRootFlags.size() == nodeCount && nodeIdIndex.size() == nodeCount && rootDistances.size() == nodeCount &&
+         retainingNodes.size() == retainingEdges.size() && !stringOffsets.empty() &&
+         stringOffsets[stringOffsets.size() - 1] == stringData.size() && validateIndex();
+    if (!ok) {
+        // 回退到解析JSON前清空已映射的数组
+        nodes.map(nullptr, 0);
+        edges.map(nullptr, 0);
+        firstEdgeIndexes.map(nullptr, 0);
+        firstRetainerIndexes.map(nullptr, 0);
+        retainingNodes.map(nullptr, 0);
+        retainingEdges.map(nullptr, 0);
+        gcRootFlags.map(nullptr, 0);
+        nodeIdIndex.map(nullptr, 0);
+        stringOffsets.map(nullptr, 0);
+        stringData.map(nullptr, 0);
+        hashIndex.map(nullptr, 0);
+        rootDistances.map(nullptr, 0);
+        return false;
+    }
+    dominatorsReady = loadDominators(*reader);
+    indexReader = std::move(reader);
+    return true;
+}
+
+// 检查索引中作为下标使用的数据都在范围内，过期或损坏的索引即使数组长度正确也会被拒绝，
+// 之后回退到解析JSON；只顺序扫描一遍映射内存，远快于解析
+bool TaskHeapSnapshot::validateIndex() const {
+    size_t nodeCount = nodes.size();
+    size_t edgeCount = edges.size();
+    size_t stringCount = stringOffsets.size() - 1;
+    if (firstEdgeIndexes[0] != 0 || static_cast<size_t>(firstEdgeIndexes[nodeCount]) != edgeCount ||
+        firstRetainerIndexes[0] != 0 ||
+        static_cast<size_t>(firstRetainerIndexes[nodeCount]) != retainingNodes.size() || stringOffsets[0] != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < nodeCount; i++) {
+        // 节点的name_id在使用处检查范围，这里不检查
+        if (firstEdgeIndexes[i + 1] < firstEdgeIndexes[i] || firstRetainerIndexes[i + 1] < firstRetainerIndexes[i] ||
+            static_cast<size_t>(nodeIdIndex[i].index) >= nodeCount ||
+            (i > 0 && nodeIdIndex[i] < nodeIdIndex[i - 1])) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < edgeCount; i++) {
+        if (static_cast<size_t>(edges[i].to_node_index) >= nodeCount) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < retainingNodes.size(); i++) {
+        if (static_cast<size_t>(retainingNodes[i]) >= nodeCount ||
+            static_cast<size_t>(retainingEdges[i]) >= edgeCount) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < stringCount; i++) {
+        if (stringOffsets[i + 1] < stringOffsets[i]) {
+            return false;
+        }
+    }
+    for (const HashIndexEntry& entry : hashIndex) {
+        if (static_cast<size_t>(entry.nodeIndex) >= nodeCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 映射索引中的支配树，旧索引没有这两个数据段或数据不对时返回false，首次查询保留大小时再计算
+bool TaskHeapSnapshot::loadDominators(const SnapshotIndexReader& reader) {
+    size_t nodeCount = nodes.size();
+    bool ok = reader.mapSection(IndexSection::DOMINATORS, dominators) &&
+              reader.mapSection(IndexSection::RETAINED_SIZES, retainedSizes) &&
+              dominators.size() == nodeCount && retainedSizes.size() == nodeCount;
+    for (size_t i = 0; ok && i < nodeCount; i++) {
+        ok = dominators[i] >= -1 && dominators[i] < static_cast<int>(nodeCount);
+    }
+    if (!ok) {
+        dominators.map(nullptr, 0);
+        retainedSizes.map(nullptr, 0);
+    }
+    return ok;
+}
+
+// 写入sidecar索引，失败时只影响下次打开的速度
+void TaskHeapSnapshot::saveIndex() const {
+    SnapshotFileStamp stamp;
+    if (!SnapshotFileStamp::read(path, stamp)) {
+        return;
+    }
+    SnapshotIndexWriter writer;
+    writer.addSection(IndexSection::NODES, nodes);
+    writer.addSection(IndexSection::EDGES, edges);
+    writer.addSection(IndexSection::FIRST_EDGE_INDEXES, firstEdgeIndexes);
+    writer.addSection(IndexSection::FIRST_RETAINER_INDEXES, firstRetainerIndexes);
+    writer.addSection(IndexSection::RETAINING_NODES, retainingNodes);
+    writer.addSection(IndexSection::RETAINING_EDGES, retainingEdges);
+    writer.addSection(IndexSection::GC_ROOT_FLAGS, gcRootFlags);
+    writer.addSection(IndexSection::NODE_ID_INDEX, nodeIdIndex);
+    writer.addSection(IndexSection::STRING_OFFSETS, stringOffsets);
+    writer.addSection(IndexSection::STRING_DATA, stringData);
+    writer.addSection(IndexSection::HASH_INDEX, hashIndex);
+    writer.addSection(IndexSection::ROOT_DISTANCES, rootDistances);
+    if (dominatorsReady) {
+        writer.addSection(IndexSection::DOMINATORS, dominators);
+        writer.addSection(IndexSection::RETAINED_SIZES, retainedSizes);
+    }
+    if (!writer.write(getSnapshotIndexPath(path), stamp)) {
+        std::cerr << "写入索引失败: " << getSnapshotIndexPath(path) << std::endl;
+    }
+}
+
+// 解析快照JSON文件
+bool TaskHeapSnapshot::parseJson(AnalysisMonitor* monitor) {
     // 使用文件流以更好地处理大文件
     FILE* fp = fopen(path.c_str(), "rb");
     if (!fp) {
@@ -326,15 +570,23 @@ bool TaskHeapSnapshot::parseSnapshot() {
     char readBuffer[65536];
     rapidjson::FileReadStream is(fp, readBuffer, sizeof(readBuffer));
     
+    ScopedPhase parsePhase(monitor, "json_parse");
     // 创建SAX解析器
     rapidjson::Reader reader;
-    TaskHeapSnapshotHandler handler(strings, nodesRaw, edgesRaw, meta);
+    TaskHeapSnapshotHandler handler(parsedStrings, nodesRaw, edgesRaw, hashIndexRaw, meta);
+    SnapshotFileStamp stamp;
+    SnapshotFileStamp::read(path, stamp);
+    handler.setMonitor(monitor, &is, stamp.size);
     
     // 解析JSON
     rapidjson::ParseResult result = reader.Parse(is, handler);
     
     fclose(fp);
     
+    if (monitor != nullptr && monitor->isCancelled()) {
+        std::cerr << "解析已取消: " << path << std::endl;
+        return false;
+    }
     if (!result) {
         std::cerr << "JSON解析失败: " << rapidjson::GetParseError_En(result.Code())
                   << " at offset " << result.Offset() << std::endl;
@@ -342,268 +594,752 @@ bool TaskHeapSnapshot::parseSnapshot() {
     }
     
     // 解析完成后，处理元数据和节点边数据
+    buildStringTable();
     parseMetaAndData();
+    parsePhase.addCounts(nodes.size() + edges.size(), stamp.size);
+    parsePhase.end();
+    if (monitor != nullptr && !monitor->report("index", stamp.size, stamp.size, nodes.size(), edges.size())) {
+        return false;
+    }
     
     // 构建引用关系
-    buildReferences();
+    {
+        ScopedPhase indexPhase(monitor, "index_build");
+        buildReferences();
+        buildGCRootFlags();
+        buildHashIndex();
+        buildRootDistances();
+        indexPhase.addCounts(nodes.size() + edges.size(), 0);
+    }
     
-    return true;
+    return monitor == nullptr || !monitor->isCancelled();
+}
+
+// 将解析得到的字符串拼接为连续的字符串表
+void TaskHeapSnapshot::buildStringTable() {
+    std::vector<uint64_t> offsets;
+    offsets.reserve(parsedStrings.size() + 1);
+    size_t totalLength = 0;
+    for (const std::string& str : parsedStrings) {
+        totalLength += str.size();
+    }
+    std::vector<char> data;
+    data.reserve(totalLength);
+    offsets.push_back(0);
+    for (const std::string& str : parsedStrings) {
+        data.insert(data.end(), str.begin(), str.end());
+        offsets.push_back(data.size());
+    }
+    std::vector<std::string>().swap(parsedStrings);
+    stringOffsets.assign(std::move(offsets));
+    stringData.assign(std::move(data));
+}
+
+// 查找字段所在的列，不存在时返回-1
+static int findFieldColumn(const std::vector<std::string>& fields, const char* name) {
+    auto it = std::find(fields.begin(), fields.end(), name);
+    if (it == fields.end()) {
+        return -1;
+    }
+    return static_cast<int>(it - fields.begin());
 }
 
 // 解析元数据和节点边数据
 void TaskHeapSnapshot::parseMetaAndData() {
-    // 解析节点数据
+    // 解析节点数据，字段列号只查找一次
     int nodeFieldsCount = meta.node_fields.size();
-    for (int i = 0; i < nodesRaw.size(); i += nodeFieldsCount) {
+    int typeColumn = findFieldColumn(meta.node_fields, "type");
+    int nameColumn = findFieldColumn(meta.node_fields, "name");
+    int idColumn = findFieldColumn(meta.node_fields, "id");
+    int edgeCountColumn = findFieldColumn(meta.node_fields, "edge_count");
+    int selfSizeColumn = findFieldColumn(meta.node_fields, "self_size");
+    int nativeSizeColumn = findFieldColumn(meta.node_fields, "native_size");
+    std::vector<HeapNode> parsedNodes;
+    if (nodeFieldsCount > 0) {
+        parsedNodes.reserve(nodesRaw.size() / nodeFieldsCount);
+    }
+    for (size_t i = 0; nodeFieldsCount > 0 && i + nodeFieldsCount <= nodesRaw.size(); i += nodeFieldsCount) {
+        const int64_t* row = &nodesRaw[i];
         HeapNode node;
-        
-        for (int j = 0; j < nodeFieldsCount; j++) {
-            const std::string& field = meta.node_fields[j];
-            int value = nodesRaw[i + j];
-            
-            if (field == "type") {
-                node.type = mapNodeType(value);
-            } else if (field == "name") {
-                std::string originalName = getStringById(value);
-                parseNodeNameAndPath(node, originalName);
-            } else if (field == "id") {
-                node.id = value;
-                nodeIdToIndexMap[value] = static_cast<int>(nodes.size());
-            } else if (field == "edge_count") {
-                node.edge_count = value;
-            }
+        if (typeColumn >= 0) {
+            node.type = toNodeType(static_cast<int>(row[typeColumn]));
         }
-        
-        nodes.push_back(node);
+        if (nameColumn >= 0) {
+            node.name_id = static_cast<int>(row[nameColumn]);
+        }
+        if (idColumn >= 0) {
+            node.id = static_cast<uint64_t>(row[idColumn]);
+        }
+        if (edgeCountColumn >= 0) {
+            node.edge_count = static_cast<int>(row[edgeCountColumn]);
+        }
+        if (selfSizeColumn >= 0) {
+            node.self_size = static_cast<uint32_t>(row[selfSizeColumn]);
+        }
+        if (nativeSizeColumn >= 0) {
+            node.native_size = static_cast<uint32_t>(row[nativeSizeColumn]);
+        }
+        parsedNodes.push_back(node);
     }
+    nodes.assign(std::move(parsedNodes));
     
     // 解析边数据
     int edgeFieldsCount = meta.edge_fields.size();
-    for (int i = 0; i < edgesRaw.size(); i += edgeFieldsCount) {
-        std::string type;
-        std::string name_or_index;
-        int to_node = 0;
-        
-        for (int j = 0; j < edgeFieldsCount; j++) {
-            const std::string& field = meta.edge_fields[j];
-            int value = edgesRaw[i + j];
-            
-            if (field == "type") {
-                type = mapEdgeType(value);
-            } else if (field == "name_or_index") {
-                // 检查是否为字符串索引
-                if (type != "element") {
-                    if (value < static_cast<int>(strings.size())) {
-                        name_or_index = strings[value];
-                    } else {
-                        name_or_index = std::to_string(value);
-                    }
-                } else {
-                    name_or_index = std::to_string(value);
-                }
-            } else if (field == "to_node") {
-                // 转换为节点索引
-                to_node = value / nodeFieldsCount;
-            }
+    int edgeTypeColumn = findFieldColumn(meta.edge_fields, "type");
+    int nameOrIndexColumn = findFieldColumn(meta.edge_fields, "name_or_index");
+    int toNodeColumn = findFieldColumn(meta.edge_fields, "to_node");
+    std::vector<Edge> parsedEdges;
+    if (edgeFieldsCount > 0) {
+        parsedEdges.reserve(edgesRaw.size() / edgeFieldsCount);
+    }
+    for (size_t i = 0; edgeFieldsCount > 0 && i + edgeFieldsCount <= edgesRaw.size(); i += edgeFieldsCount) {
+        const int* row = &edgesRaw[i];
+        HeapEdgeType type = edgeTypeColumn >= 0 ? toEdgeType(row[edgeTypeColumn]) : HeapEdgeType::UNKNOWN;
+        int nameOrIndex = nameOrIndexColumn >= 0 ? row[nameOrIndexColumn] : 0;
+        // 转换为节点索引
+        int toNode = toNodeColumn >= 0 && nodeFieldsCount > 0 ? row[toNodeColumn] / nodeFieldsCount : 0;
+        parsedEdges.emplace_back(type, nameOrIndex, toNode);
+    }
+    edges.assign(std::move(parsedEdges));
+    
+    // 原始数据已转换完毕，释放内存
+    std::vector<int64_t>().swap(nodesRaw);
+    
+    buildNodeIdIndex();
+    std::vector<int>().swap(edgesRaw);
+}
+
+// 构建按id排序的(id, 节点索引)数组，用于二分查找
+void TaskHeapSnapshot::buildNodeIdIndex() {
+    std::vector<NodeIdEntry> index(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        index[i].id = nodes[i].id;
+        index[i].index = static_cast<int>(i);
+    }
+    // 快照中的id通常已按节点顺序递增，已有序时跳过排序
+    if (!std::is_sorted(index.begin(), index.end())) {
+        std::stable_sort(index.begin(), index.end());
+    }
+    nodeIdIndex.assign(std::move(index));
+}
+
+// 根据节点id查找节点索引，不存在时返回-1
+int TaskHeapSnapshot::findNodeIndexById(uint64_t nodeId) const {
+    NodeIdEntry key;
+    key.id = nodeId;
+    key.index = 0;
+    auto it = std::lower_bound(nodeIdIndex.begin(), nodeIdIndex.end(), key);
+    if (it == nodeIdIndex.end() || it->id != nodeId) {
+        return -1;
+    }
+    return it->index;
+}
+
+void TaskHeapSnapshot::collectObjects(rawheap_translate::HeapObjects& objects) const {
+    // 分组规则与rawheap输入相同，见HeapObjects::ClassName；object和native节点按名称，其余按节点类型
+    std::unordered_map<int, uint32_t> nameClasses;
+    std::vector<uint32_t> typeClasses(static_cast<size_t>(HeapNodeType::UNKNOWN) + 1, UINT32_MAX);
+    objects.classNames.clear();
+    objects.objects.clear();
+    objects.objects.reserve(nodeIdIndex.size());
+    for (const NodeIdEntry& entry : nodeIdIndex) {
+        const HeapNode& node = nodes[entry.index];
+        // 合成根节点和id为0的Int:<hash>节点不是堆对象
+        if (node.id == 0 || node.type == HeapNodeType::SYNTHETIC) {
+            continue;
         }
-        
-        edges.emplace_back(type, name_or_index, to_node);
+        bool named = node.type == HeapNodeType::OBJECT || node.type == HeapNodeType::NATIVE;
+        uint32_t& classIndex = named ? nameClasses.emplace(node.name_id, UINT32_MAX).first->second
+                                     : typeClasses[static_cast<size_t>(node.type)];
+        if (classIndex == UINT32_MAX) {
+            classIndex = static_cast<uint32_t>(objects.classNames.size());
+            objects.classNames.push_back(rawheap_translate::HeapObjects::ClassName(
+                static_cast<rawheap_translate::NodeType>(node.type), named ? getStringById(node.name_id) : ""));
+        }
+        rawheap_translate::HeapObject object;
+        object.id = node.id;
+        object.size = static_cast<uint64_t>(node.self_size) + node.native_size;
+        object.classIndex = classIndex;
+        objects.objects.push_back(object);
     }
 }
 
-// 构建引用关系
+// 构建引用关系（CSR形式的出边与引用者索引）
 void TaskHeapSnapshot::buildReferences() {
-    int edgeIndex = 0;
+    int nodeCount = static_cast<int>(nodes.size());
+    int edgeCount = static_cast<int>(edges.size());
+    
+    std::vector<int> edgeStarts(nodeCount + 1, 0);
+    for (int i = 0; i < nodeCount; i++) {
+        edgeStarts[i + 1] = std::min(edgeStarts[i] + nodes[i].edge_count, edgeCount);
+    }
+    
+    // 统计每个节点的引用者数量
+    std::vector<int> retainerStarts(nodeCount + 1, 0);
+    for (int e = 0; e < edgeStarts[nodeCount]; e++) {
+        int toNodeIndex = edges[e].to_node_index;
+        if (toNodeIndex >= 0 && toNodeIndex < nodeCount) {
+            retainerStarts[toNodeIndex + 1]++;
+        }
+    }
+    for (int i = 0; i < nodeCount; i++) {
+        retainerStarts[i + 1] += retainerStarts[i];
+    }
+    
+    // 填充引用者
+    std::vector<int> retainerNodes(retainerStarts[nodeCount], 0);
+    std::vector<int> retainerEdges(retainerStarts[nodeCount], 0);
+    std::vector<int> cursor(retainerStarts.begin(), retainerStarts.end() - 1);
+    for (int i = 0; i < nodeCount; i++) {
+        for (int e = edgeStarts[i]; e < edgeStarts[i + 1]; e++) {
+            int toNodeIndex = edges[e].to_node_index;
+            if (toNodeIndex >= 0 && toNodeIndex < nodeCount) {
+                int pos = cursor[toNodeIndex]++;
+                retainerNodes[pos] = i;
+                retainerEdges[pos] = e;
+            }
+        }
+    }
+    
+    firstEdgeIndexes.assign(std::move(edgeStarts));
+    firstRetainerIndexes.assign(std::move(retainerStarts));
+    retainingNodes.assign(std::move(retainerNodes));
+    retainingEdges.assign(std::move(retainerEdges));
+}
+
+// 预先计算每个节点是否为GC根，同名节点只判断一次
+void TaskHeapSnapshot::buildGCRootFlags() {
+    // 每个字符串是否为GC根名称：-1未知，0否，1是
+    int stringCount = static_cast<int>(stringOffsets.size()) - 1;
+    std::vector<int8_t> rootNames(stringCount, -1);
+    std::vector<uint8_t> flags(nodes.size(), 0);
     for (size_t i = 0; i < nodes.size(); i++) {
-        HeapNode& node = nodes[i];
-        int edgeCount = node.edge_count;
-        
-        for (int j = 0; j < edgeCount; j++) {
-            if (edgeIndex + j >= edges.size()) break;
-            
-            const Edge& edge = edges[edgeIndex + j];
-            int toNodeIndex = edge.to_node_index;
-            
-            if (toNodeIndex >= 0 && toNodeIndex < static_cast<int>(nodes.size())) {
-                HeapNode& toNode = nodes[toNodeIndex];
-                toNode.references.emplace_back(static_cast<int>(i), edge.type, edge.name_or_index);
+        const HeapNode& node = nodes[i];
+        if (node.type == HeapNodeType::SYNTHETIC || node.type == HeapNodeType::HIDDEN) {
+            flags[i] = 1;
+            continue;
+        }
+        if (node.name_id < 0 || node.name_id >= stringCount) {
+            continue;
+        }
+        int8_t& rootName = rootNames[node.name_id];
+        if (rootName < 0) {
+            ReferenceChainNode chainNode;
+            parseNodeNameAndPath(chainNode, getStringById(node.name_id));
+            rootName = isGCRoot(node.type, chainNode.name) ? 1 : 0;
+        }
+        flags[i] = rootName == 1 ? 1 : 0;
+    }
+    gcRootFlags.assign(std::move(flags));
+}
+
+// 解析"Int:<hash>"形式的名称，成功时返回true
+static bool parseHashName(const char* str, size_t length, int64_t& hash) {
+    static const char prefix[] = "Int:";
+    const size_t prefixLength = sizeof(prefix) - 1;
+    if (length <= prefixLength || length - prefixLength > 20 || memcmp(str, prefix, prefixLength) != 0) {
+        return false;
+    }
+    char buffer[24];
+    memcpy(buffer, str + prefixLength, length - prefixLength);
+    buffer[length - prefixLength] = '\0';
+    char* end = nullptr;
+    hash = strtoll(buffer, &end, 10);
+    return end == buffer + (length - prefixLength);
+}
+
+// 构建hash索引：同一hash取第一个"Int:<hash>"数值节点，再取它第一个经ArkInternalHash边的引用者；
+// 快照带ark_hash_index时直接使用其中的(hash, 节点索引)
+void TaskHeapSnapshot::buildHashIndex() {
+    std::vector<HashIndexEntry> entries;
+    if (!hashIndexRaw.empty()) {
+        int nodeCount = static_cast<int>(nodes.size());
+        entries.reserve(hashIndexRaw.size() / 2);
+        for (size_t i = 0; i + 1 < hashIndexRaw.size(); i += 2) {
+            if (hashIndexRaw[i + 1] < 0 || hashIndexRaw[i + 1] >= nodeCount) {
+                continue;
+            }
+            HashIndexEntry entry;
+            entry.hash = hashIndexRaw[i];
+            entry.nodeIndex = static_cast<int>(hashIndexRaw[i + 1]);
+            entries.push_back(entry);
+        }
+        std::vector<int64_t>().swap(hashIndexRaw);
+        std::stable_sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end(),
+            [](const HashIndexEntry& a, const HashIndexEntry& b) { return a.hash == b.hash; }), entries.end());
+        hashIndex.assign(std::move(entries));
+        return;
+    }
+    int hashEdgeNameId = findStringId("ArkInternalHash");
+    int stringCount = static_cast<int>(stringOffsets.size()) - 1;
+    if (hashEdgeNameId < 0) {
+        hashIndex.assign(std::move(entries));
+        return;
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const HeapNode& node = nodes[i];
+        int64_t hash = 0;
+        if (node.type != HeapNodeType::NUMBER || node.name_id < 0 || node.name_id >= stringCount ||
+            !parseHashName(stringData.data() + stringOffsets[node.name_id],
+                           stringOffsets[node.name_id + 1] - stringOffsets[node.name_id], hash)) {
+            continue;
+        }
+        HashIndexEntry entry;
+        entry.hash = hash;
+        entry.nodeIndex = static_cast<int>(i);
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end(),
+        [](const HashIndexEntry& a, const HashIndexEntry& b) { return a.hash == b.hash; }), entries.end());
+    
+    // 将数值节点替换为持有它的节点，没有ArkInternalHash引用者的项丢弃
+    size_t count = 0;
+    for (const HashIndexEntry& entry : entries) {
+        int hashNodeIndex = entry.nodeIndex;
+        for (int r = firstRetainerIndexes[hashNodeIndex]; r < firstRetainerIndexes[hashNodeIndex + 1]; r++) {
+            const Edge& edge = edges[retainingEdges[r]];
+            if (edge.type != HeapEdgeType::ELEMENT && edge.name_or_index == hashEdgeNameId) {
+                entries[count].hash = entry.hash;
+                entries[count].nodeIndex = retainingNodes[r];
+                count++;
+                break;
+            }
+        }
+    }
+    entries.resize(count);
+    hashIndex.assign(std::move(entries));
+}
+
+// 从根节点(索引0)沿非弱引用边做BFS，记录每个节点的最短距离
+void TaskHeapSnapshot::buildRootDistances() {
+    int nodeCount = static_cast<int>(nodes.size());
+    std::vector<int32_t> distances(nodeCount, -1);
+    if (nodeCount > 0) {
+        std::vector<int> queue;
+        queue.reserve(nodeCount);
+        queue.push_back(0);
+        distances[0] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int nodeIndex = queue[head];
+            for (int e = firstEdgeIndexes[nodeIndex]; e < firstEdgeIndexes[nodeIndex + 1]; e++) {
+                const Edge& edge = edges[e];
+                int toNodeIndex = edge.to_node_index;
+                if (edge.type == HeapEdgeType::WEAK || toNodeIndex < 0 || toNodeIndex >= nodeCount ||
+                    distances[toNodeIndex] >= 0) {
+                    continue;
+                }
+                distances[toNodeIndex] = distances[nodeIndex] + 1;
+                queue.push_back(toNodeIndex);
             }
         }
-        
-        edgeIndex += edgeCount;
     }
+    rootDistances.assign(std::move(distances));
 }
 
 // 使用BFS算法查找从目标节点到GC根的最短引用链
-std::vector<ReferenceChain> TaskHeapSnapshot::getShortestPathToGCRoot(int nodeId, int maxDepth) {
-    std::vector<ReferenceChain> shortestChain;
-    
+std::vector<ReferenceChain> TaskHeapSnapshot::getShortestPathToGCRoot(uint64_t nodeId, int maxDepth,
+                                                                      AnalysisMonitor* monitor) {
     // 查找目标节点
-    auto it = nodeIdToIndexMap.find(nodeId);
-    if (it == nodeIdToIndexMap.end()) {
+    int targetNodeIndex = findNodeIndexById(nodeId);
+    if (targetNodeIndex < 0) {
         std::cerr << "未找到ID为 " << nodeId << " 的节点" << std::endl;
-        return shortestChain;
+        return std::vector<ReferenceChain>();
     }
-    
-    int targetNodeIndex = it->second;
-    const HeapNode& targetNode = nodes[targetNodeIndex];
+    return getShortestPathToGCRootByIndex(targetNodeIndex, maxDepth, monitor);
+}
+
+std::vector<ReferenceChain> TaskHeapSnapshot::getShortestPathToGCRootByIndex(int targetNodeIndex, int maxDepth,
+                                                                             AnalysisMonitor* monitor) {
+    std::vector<ReferenceChain> shortestChain;
     
     // 如果目标节点本身就是GC根，返回空链
-    if (isGCRoot(targetNode.type, targetNode.name)) {
+    if (gcRootFlags[targetNodeIndex]) {
         return shortestChain;
     }
     
-    // BFS队列：(当前节点索引, 路径)
-    std::queue<std::pair<int, std::vector<ReferenceChain>>> queue;
-    
-    // 访问标记
-    std::vector<bool> visited(nodes.size(), false);
+    // BFS只记录每个节点的深度和发现它时经过的节点与边，找到GC根后再回溯生成引用链
+    ScopedPhase phase(monitor, "bfs");
+    int nodeCount = static_cast<int>(nodes.size());
+    std::vector<int> depth(nodeCount, -1);
+    std::vector<int> viaNode(nodeCount, -1);
+    std::vector<int> viaEdge(nodeCount, -1);
+    std::vector<int> queue;
+    size_t head = 0;
     
     // 初始化队列
-    queue.push({targetNodeIndex, {}});
-    visited[targetNodeIndex] = true;
-    
-    // 最短路径长度标记
-    bool foundShortest = false;
+    queue.push_back(targetNodeIndex);
+    depth[targetNodeIndex] = 0;
+    int foundNodeIndex = -1;
     
-    while (!queue.empty()) {
-        auto [currentNodeIndex, currentPath] = queue.front();
-        queue.pop();
+    while (head < queue.size()) {
+        // 定期检查取消，已取消时放弃本次查询
+        if (monitor != nullptr && (head & 0xFFF) == 0 && monitor->isCancelled()) {
+            return shortestChain;
+        }
+        int currentNodeIndex = queue[head++];
+        int currentDepth = depth[currentNodeIndex];
         
         // 检查是否超过最大深度
-        if (currentPath.size() >= maxDepth) {
+        if (currentDepth >= maxDepth) {
             continue;
         }
         
-        const HeapNode& currentNode = nodes[currentNodeIndex];
-        
         // 检查当前节点是否是GC根
-        if (isGCRoot(currentNode.type, currentNode.name)) {
+        if (gcRootFlags[currentNodeIndex]) {
             // 如果找到GC根且路径非空，这就是最短路径
-            if (!currentPath.empty()) {
-                shortestChain = currentPath;
-                foundShortest = true;
+            if (currentDepth > 0) {
+                foundNodeIndex = currentNodeIndex;
                 break; // 找到第一条最短路径后立即返回
             }
             continue;
         }
         
         // 遍历当前节点的所有引用者
-        for (const Reference& ref : currentNode.references) {
-            int referrerIndex = ref.from_node_index;
+        for (int r = firstRetainerIndexes[currentNodeIndex]; r < firstRetainerIndexes[currentNodeIndex + 1]; r++) {
+            int referrerIndex = retainingNodes[r];
             
             // 跳过已访问的节点
-            if (visited[referrerIndex]) {
+            if (depth[referrerIndex] >= 0) {
                 continue;
             }
             
-            const HeapNode& referrer = nodes[referrerIndex];
-            
             // 跳过直接的GC根引用
-            if (isGCRoot(referrer.type, referrer.name) && currentPath.empty()) {
+            if (gcRootFlags[referrerIndex] && currentDepth == 0) {
                 continue;
             }
             // 跳过弱引用
-            if (ref.type == "weak"  && currentPath.empty()) {
+            if (edges[retainingEdges[r]].type == HeapEdgeType::WEAK && currentDepth == 0) {
                 continue;
             }
-                
-            // 创建新的引用链节点
-            ReferenceChainNode referrerNode(referrer.id, referrer.name, referrer.type, 
-                                           referrer.path, referrer.line);
-            
-            ReferenceChainNode currentNodeRef(currentNode.id, currentNode.name, currentNode.type, 
-                                             currentNode.path, currentNode.line);
-            
-            // 创建新的引用链
-            ReferenceChain newChain(referrerNode, ref.type, currentNodeRef);
-            
-            // 创建新的路径
-            std::vector<ReferenceChain> newPath = currentPath;
-            newPath.push_back(newChain);
             
             // 添加到队列
-            queue.push({referrerIndex, newPath});
-            visited[referrerIndex] = true;
+            depth[referrerIndex] = currentDepth + 1;
+            viaNode[referrerIndex] = currentNodeIndex;
+            viaEdge[referrerIndex] = retainingEdges[r];
+            queue.push_back(referrerIndex);
         }
     }
     
+    phase.addCounts(queue.size(), 0);
+    if (foundNodeIndex < 0) {
+        return shortestChain;
+    }
+    
+    // 从GC根回溯到目标节点，再反转为从目标节点开始的顺序
+    for (int referrerIndex = foundNodeIndex; referrerIndex != targetNodeIndex; referrerIndex = viaNode[referrerIndex]) {
+        int currentNodeIndex = viaNode[referrerIndex];
+        shortestChain.emplace_back(makeChainNode(referrerIndex), mapEdgeType(edges[viaEdge[referrerIndex]].type),
+                                   makeChainNode(currentNodeIndex));
+    }
+    std::reverse(shortestChain.begin(), shortestChain.end());
+    
     return shortestChain;
 }
 
-HeapNode* TaskHeapSnapshot::findHashNodeByName(const std::string& targetName) {
-    auto it = std::find_if(nodes.begin(), nodes.end(),
-        [&targetName](const HeapNode& node) {
-            return node.name == targetName && node.type == "number";
-        });
-    
-    if (it != nodes.end()) {
-        // 获取该节点的引用列表
-        const std::vector<Reference>& refs = it->references;
-        
-        // 在引用列表中查找 name_or_index 为 "ArkInternalHash" 的引用
-        auto refIt = std::find_if(refs.begin(), refs.end(),
-            [](const Reference& ref) {
-                return ref.name_or_index == "ArkInternalHash";
-            });
-        
-        if (refIt != refs.end()) {
-            // 找到目标引用，返回引用指向的节点
-            int targetNodeIndex = refIt->from_node_index;
-            if (targetNodeIndex >= 0 && targetNodeIndex < static_cast<int>(nodes.size())) {
-                return &nodes[targetNodeIndex];
-            }
-        }
+// 通过hash名称查找持有该hash的节点索引，不存在时返回-1
+int TaskHeapSnapshot::findHashNodeIndexByName(const std::string& targetName) const {
+    int64_t hash = 0;
+    if (!parseHashName(targetName.data(), targetName.size(), hash)) {
+        return -1;
     }
-    return nullptr;
+    HashIndexEntry key;
+    key.hash = hash;
+    key.nodeIndex = 0;
+    auto it = std::lower_bound(hashIndex.begin(), hashIndex.end(), key);
+    if (it == hashIndex.end() || it->hash != hash) {
+        return -1;
+    }
+    return it->nodeIndex;
 }
 
-std::vector<ReferenceChain> TaskHeapSnapshot::getShortestPathToGCRootByName(const std::string& nodeName, int maxDepth) {
+std::vector<ReferenceChain> TaskHeapSnapshot::getShortestPathToGCRootByName(const std::string& nodeName, int maxDepth,
+                                                                            AnalysisMonitor* monitor) {
     
     // 查找所有名称匹配的节点
-    const HeapNode* node = findHashNodeByName(nodeName);
+    int nodeIndex = findHashNodeIndexByName(nodeName);
   
-    if (node == nullptr) {
+    if (nodeIndex < 0) {
         std::cerr << "未找到名称包含 \"" << nodeName << "\" 的节点" << std::endl;
         return std::vector<ReferenceChain>();
     }
-    std::vector<ReferenceChain> chain = getShortestPathToGCRoot(node->id,maxDepth);
+    std::vector<ReferenceChain> chain = getShortestPathToGCRootByIndex(nodeIndex, maxDepth, monitor);
     return chain;
 }
 
+// 从根节点(索引0)沿非弱引用边做迭代DFS，生成后序编号，不可达节点编号为-1
+void TaskHeapSnapshot::buildPostOrder(std::vector<int>& postOrderToNode, std::vector<int>& nodeToPostOrder) const {
+    int nodeCount = static_cast<int>(nodes.size());
+    postOrderToNode.clear();
+    postOrderToNode.reserve(nodeCount);
+    nodeToPostOrder.assign(nodeCount, -1);
+    if (nodeCount == 0) {
+        return;
+    }
+    
+    std::vector<bool> visited(nodeCount, false);
+    // 栈：(节点索引, 下一条待访问的边)
+    std::vector<std::pair<int, int>> stack;
+    stack.emplace_back(0, firstEdgeIndexes[0]);
+    visited[0] = true;
+    
+    while (!stack.empty()) {
+        int nodeIndex = stack.back().first;
+        int& edgeIndex = stack.back().second;
+        if (edgeIndex < firstEdgeIndexes[nodeIndex + 1]) {
+            const Edge& edge = edges[edgeIndex++];
+            int toNodeIndex = edge.to_node_index;
+            if (edge.type == HeapEdgeType::WEAK || toNodeIndex < 0 || toNodeIndex >= nodeCount || visited[toNodeIndex]) {
+                continue;
+            }
+            visited[toNodeIndex] = true;
+            stack.emplace_back(toNodeIndex, firstEdgeIndexes[toNodeIndex]);
+        } else {
+            nodeToPostOrder[nodeIndex] = static_cast<int>(postOrderToNode.size());
+            postOrderToNode.push_back(nodeIndex);
+            stack.pop_back();
+        }
+    }
+}
+
+// Cooper-Harvey-Kennedy迭代算法计算支配树，再按后序累加保留大小
+void TaskHeapSnapshot::computeDominatorTree(AnalysisMonitor* monitor) {
+    // 同一快照可能被多个任务并发查询，只计算一次
+    std::lock_guard<std::mutex> lock(dominatorMutex);
+    if (dominatorsReady) {
+        return;
+    }
+    ScopedPhase phase(monitor, "dominators");
+    
+    int nodeCount = static_cast<int>(nodes.size());
+    std::vector<int> postOrderToNode;
+    std::vector<int> nodeToPostOrder;
+    buildPostOrder(postOrderToNode, nodeToPostOrder);
+    
+    int reachableCount = static_cast<int>(postOrderToNode.size());
+    // 以后序编号表示的直接支配者，-1表示尚未计算
+    std::vector<int> doms(reachableCount, -1);
+    if (reachableCount > 0) {
+        int rootPostOrder = reachableCount - 1;
+        doms[rootPostOrder] = rootPostOrder;
+        
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            // 按逆后序遍历除根以外的节点
+            for (int po = rootPostOrder - 1; po >= 0; po--) {
+                int nodeIndex = postOrderToNode[po];
+                int newDom = -1;
+                for (int r = firstRetainerIndexes[nodeIndex]; r < firstRetainerIndexes[nodeIndex + 1]; r++) {
+                    int retainerPostOrder = nodeToPostOrder[retainingNodes[r]];
+                    if (retainerPostOrder < 0 || doms[retainerPostOrder] < 0 ||
+                        edges[retainingEdges[r]].type == HeapEdgeType::WEAK) {
+                        continue;
+                    }
+                    if (newDom < 0) {
+                        newDom = retainerPostOrder;
+                        continue;
+                    }
+                    // 沿支配树上溯求两个节点的最近公共支配者
+                    int finger1 = retainerPostOrder;
+                    int finger2 = newDom;
+                    while (finger1 != finger2) {
+                        while (finger1 < finger2) {
+                            finger1 = doms[finger1];
+                        }
+                        while (finger2 < finger1) {
+                            finger2 = doms[finger2];
+                        }
+                    }
+                    newDom = finger1;
+                }
+                if (doms[po] != newDom) {
+                    doms[po] = newDom;
+                    changed = true;
+                }
+            }
+        }
+    }
+    
+    std::vector<int> dominatorIndexes(nodeCount, -1);
+    std::vector<uint64_t> sizes(nodeCount, 0);
+    for (int i = 0; i < nodeCount; i++) {
+        sizes[i] = static_cast<uint64_t>(nodes[i].self_size) + nodes[i].native_size;
+    }
+    // 直接支配者的后序编号总是大于被支配节点，按后序累加即可保证子树先于父节点完成
+    for (int po = 0; po < reachableCount - 1; po++) {
+        int nodeIndex = postOrderToNode[po];
+        int dominatorIndex = postOrderToNode[doms[po]];
+        dominatorIndexes[nodeIndex] = dominatorIndex;
+        sizes[dominatorIndex] += sizes[nodeIndex];
+    }
+    if (reachableCount > 0) {
+        dominatorIndexes[0] = 0;
+    }
+    dominators.assign(std::move(dominatorIndexes));
+    retainedSizes.assign(std::move(sizes));
+    phase.addCounts(static_cast<uint64_t>(reachableCount), 0);
+    phase.end();
+    
+    dominatorsReady = true;
+    // 补写进sidecar索引，下次打开不必再计算；整个索引重写一次，映射中的旧文件不受影响
+    if (useIndex) {
+        ScopedPhase savePhase(monitor, "index_save");
+        saveIndex();
+    }
+}
+
+void TaskHeapSnapshot::fillRetainedInfo(int nodeIndex, RetainedInfo& info, bool withRetained) {
+    const HeapNode& node = nodes[nodeIndex];
+    info.id = node.id;
+    info.self_size = static_cast<uint64_t>(node.self_size) + node.native_size;
+    info.distance = rootDistances[nodeIndex];
+    if (!withRetained) {
+        return;
+    }
+    computeDominatorTree();
+    info.retained_size = retainedSizes[nodeIndex];
+    int dominatorIndex = dominators[nodeIndex];
+    info.dominator_id = dominatorIndex >= 0 ? nodes[dominatorIndex].id : 0;
+}
+
+bool TaskHeapSnapshot::getRetainedInfo(uint64_t nodeId, RetainedInfo& info) {
+    int nodeIndex = findNodeIndexById(nodeId);
+    if (nodeIndex < 0) {
+        std::cerr << "未找到ID为 " << nodeId << " 的节点" << std::endl;
+        return false;
+    }
+    fillRetainedInfo(nodeIndex, info, true);
+    return true;
+}
+
+bool TaskHeapSnapshot::getRetainedInfoByName(const std::string& nodeName, RetainedInfo& info, bool withRetained) {
+    int nodeIndex = findHashNodeIndexByName(nodeName);
+    if (nodeIndex < 0) {
+        return false;
+    }
+    fillRetainedInfo(nodeIndex, info, withRetained);
+    return true;
+}
+
+size_t TaskHeapSnapshot::memoryUsage() const {
+    size_t bytes = stringOffsets.ownedBytes() + stringData.ownedBytes() + nodes.ownedBytes() + edges.ownedBytes() +
+                   nodeIdIndex.ownedBytes() + hashIndex.ownedBytes() + firstEdgeIndexes.ownedBytes() +
+                   firstRetainerIndexes.ownedBytes() + retainingNodes.ownedBytes() + retainingEdges.ownedBytes() +
+                   gcRootFlags.ownedBytes() + rootDistances.ownedBytes();
+    // 支配树在首次查询保留大小时才计算，还没有时按计算后的大小预留
+    if (dominatorsReady) {
+        bytes += dominators.ownedBytes() + retainedSizes.ownedBytes();
+    } else {
+        bytes += nodes.size() * (sizeof(int) + sizeof(uint64_t));
+    }
+    return bytes;
+}
+
 // 初始化TaskManager静态成员
-std::map<int, std::unique_ptr<TaskHeapSnapshot>> TaskManager::tasks;
+std::mutex TaskManager::mutex;
+std::map<int, std::shared_ptr<TaskHeapSnapshot>> TaskManager::tasks;
 int TaskManager::nextTaskId = 1;
+std::list<TaskManager::CacheEntry> TaskManager::cache;
+size_t TaskManager::cacheBytes = 0;
+// 默认预算能容纳一个刚解析的百万节点快照，从sidecar索引重新打开的快照只占很少的堆内存
+size_t TaskManager::cacheBudget = 256 * 1024 * 1024;
+
+// 查找与快照文件一致的缓存并移到最前，快照已变化时丢弃旧缓存，调用前需持有mutex
+std::shared_ptr<TaskHeapSnapshot> TaskManager::findCached(const std::string& path, const SnapshotFileStamp& stamp) {
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->path != path) {
+            continue;
+        }
+        if (!(it->stamp == stamp)) {
+            cacheBytes -= it->bytes;
+            cache.erase(it);
+            return nullptr;
+        }
+        cache.splice(cache.begin(), cache, it);
+        return it->snapshot;
+    }
+    return nullptr;
+}
+
+// 加入缓存并按预算淘汰，调用前需持有mutex
+void TaskManager::addToCache(const std::string& path, const SnapshotFileStamp& stamp,
+                             const std::shared_ptr<TaskHeapSnapshot>& snapshot) {
+    size_t bytes = snapshot->memoryUsage();
+    if (bytes > cacheBudget) {
+        return;
+    }
+    cache.push_front({path, stamp, snapshot, bytes});
+    cacheBytes += bytes;
+    trimCache();
+}
+
+// 淘汰最久未使用的快照直到不超过预算，正在被任务使用的快照在任务销毁后释放
+void TaskManager::trimCache() {
+    while (cacheBytes > cacheBudget && !cache.empty()) {
+        cacheBytes -= cache.back().bytes;
+        cache.pop_back();
+    }
+}
 
 // 创建新任务
-int TaskManager::createTask(const std::string& path) {
-    int taskId = nextTaskId++;
-    auto task = std::make_unique<TaskHeapSnapshot>(taskId, path);
+int TaskManager::createTask(const std::string& path, bool useIndex, AnalysisMonitor* monitor) {
+    SnapshotFileStamp stamp;
+    bool cacheable = useIndex && SnapshotFileStamp::read(path, stamp);
+    std::shared_ptr<TaskHeapSnapshot> snapshot;
+    if (cacheable) {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = findCached(path, stamp);
+    }
     
-    // 解析快照文件
-    if (task->parseSnapshot()) {
-        tasks[taskId] = std::move(task);
-        return taskId;
-    } else {
-        return -1; // 创建失败
+    if (!snapshot) {
+        // 解析耗时较长，不持有锁，其他线程可以同时查询已有任务
+        snapshot = std::make_shared<TaskHeapSnapshot>(path, useIndex);
+        if (!snapshot->parseSnapshot(monitor)) {
+            return -1; // 创建失败
+        }
+        if (cacheable) {
+            std::lock_guard<std::mutex> lock(mutex);
+            // 其他线程可能已解析过同一快照，优先使用已缓存的
+            std::shared_ptr<TaskHeapSnapshot> cached = findCached(path, stamp);
+            if (cached) {
+                snapshot = cached;
+            } else {
+                addToCache(path, stamp, snapshot);
+            }
+        }
     }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    int taskId = nextTaskId++;
+    tasks[taskId] = snapshot;
+    return taskId;
 }
 
-// 获取任务
-TaskHeapSnapshot* TaskManager::getTask(int id) {
+// 获取任务，返回的快照在任务销毁后仍然有效
+std::shared_ptr<TaskHeapSnapshot> TaskManager::getTask(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
     auto it = tasks.find(id);
     if (it != tasks.end()) {
-        return it->second.get();
+        return it->second;
     }
     return nullptr;
 }
 
 // 销毁任务
 bool TaskManager::destroyTask(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
     auto it = tasks.find(id);
     if (it != tasks.end()) {
         tasks.erase(it);
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+void TaskManager::setCacheBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    cacheBudget = bytes;
+    trimCache();
+}
@@ -4,29 +4,50 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <cstdint>
+#include "analysis_monitor.h"
+#include "snapshot_index.h"
+
+namespace rawheap_translate {
+struct HeapObjects;
+}
+
+// 节点类型，顺序与heapsnapshot meta中的node_types一致
+enum class HeapNodeType : uint8_t {
+    HIDDEN, ARRAY, STRING, OBJECT, CODE, CLOSURE, REGEXP, NUMBER, NATIVE, SYNTHETIC,
+    CONCATENATED_STRING, SLICED_STRING, SYMBOL, BIGINT, FRAMEWORK, UNKNOWN
+};
+
+// 边类型，顺序与heapsnapshot meta中的edge_types一致
+enum class HeapEdgeType : uint8_t { CONTEXT, ELEMENT, PROPERTY, INTERNAL, HIDDEN, SHORTCUT, WEAK, UNKNOWN };
 
 // 定义GC根类型的检查
 bool isGCRoot(const std::string& nodeType, const std::string& nodeName);
+bool isGCRoot(HeapNodeType nodeType, const std::string& nodeName);
 
 // 边类型映射函数
 std::string mapEdgeType(int typeCode);
+std::string mapEdgeType(HeapEdgeType type);
 
 // 节点类型映射函数
 std::string mapNodeType(int typeCode);
+std::string mapNodeType(HeapNodeType type);
 
 
 
 // 引用链节点
 struct ReferenceChainNode {
-    int id;
+    uint64_t id;
     std::string name;
     std::string type;
     std::string path;
     int line;
     
     ReferenceChainNode() : id(0), line(0) {}
-    ReferenceChainNode(int id_, const std::string& name_, const std::string& type_, 
+    ReferenceChainNode(uint64_t id_, const std::string& name_, const std::string& type_, 
                        const std::string& path_ = "", int line_ = 0)
         : id(id_), name(name_), type(type_), path(path_), line(line_) {}
 };
@@ -42,70 +63,148 @@ struct ReferenceChain {
         : referrer(referrer_), edge_type(edge_type_), current_node(current_node_) {}
 };
 
-// 节点引用
-struct Reference {
-    int from_node_index;
-    std::string type;
-    std::string name_or_index;
+// 保留大小信息
+struct RetainedInfo {
+    uint64_t id;
+    uint64_t self_size;       // self_size + native_size
+    uint64_t retained_size;   // 被该节点支配的所有节点的大小之和
+    uint64_t dominator_id;    // 直接支配者的节点ID，不可达时为0
+    int distance;             // 从根节点出发的最短引用距离，不可达时为-1
     
-    Reference(int from_node_index_, const std::string& type_, const std::string& name_or_index_)
-        : from_node_index(from_node_index_), type(type_), name_or_index(name_or_index_) {}
+    RetainedInfo() : id(0), self_size(0), retained_size(0), dominator_id(0), distance(-1) {}
 };
 
-// 堆节点
+// 堆节点，名称在输出引用链时才解析为name/path/line
 struct HeapNode {
-    int id;
-    std::string name;
-    std::string type;
-    std::string path;
-    int line;
-    std::string module;
+    uint64_t id;
+    int name_id;
+    HeapNodeType type;
     int edge_count;
-    std::vector<Reference> references;
+    uint32_t self_size;
+    uint32_t native_size;
     
-    HeapNode() : id(0), line(0), edge_count(0) {}
+    HeapNode() : id(0), name_id(0), type(HeapNodeType::HIDDEN), edge_count(0), self_size(0), native_size(0) {}
 };
 
-// 边
+// 边，element边的name_or_index为下标，其余为字符串索引
 struct Edge {
-    std::string type;
-    std::string name_or_index;
+    HeapEdgeType type;
+    int name_or_index;
     int to_node_index;
     
-    Edge(const std::string& type_, const std::string& name_or_index_, int to_node_index_)
+    Edge(HeapEdgeType type_, int name_or_index_, int to_node_index_)
         : type(type_), name_or_index(name_or_index_), to_node_index(to_node_index_) {}
 };
 
-// 任务堆快照
+// 按id排序的节点索引项
+struct NodeIdEntry {
+    uint64_t id;
+    int index;
+    
+    bool operator<(const NodeIdEntry& other) const { return id < other.id; }
+};
+
+// 按hash排序的hash索引项，nodeIndex为通过ArkInternalHash边持有该hash的节点
+struct HashIndexEntry {
+    int64_t hash;
+    int nodeIndex;
+    
+    bool operator<(const HashIndexEntry& other) const { return hash < other.hash; }
+};
+
+// 任务堆快照，解析完成后只读，可被多个任务和线程共享
 class TaskHeapSnapshot {
 private:
-    int id;
     std::string path;
-    std::vector<std::string> strings;
-    std::vector<HeapNode> nodes;
-    std::vector<Edge> edges;
-    std::map<int, int> nodeIdToIndexMap;
+    bool useIndex;
+    // 字符串表：第i个字符串为 stringData[stringOffsets[i], stringOffsets[i + 1])
+    IndexArray<uint64_t> stringOffsets;
+    IndexArray<char> stringData;
+    IndexArray<HeapNode> nodes;
+    IndexArray<Edge> edges;
+    IndexArray<NodeIdEntry> nodeIdIndex;
+    IndexArray<HashIndexEntry> hashIndex;
     
 public:
-    TaskHeapSnapshot(int id_, const std::string& path_)
-        : id(id_), path(path_) {}
+    // useIndex为true时优先加载sidecar索引，首次解析后写入索引供下次打开使用
+    explicit TaskHeapSnapshot(const std::string& path_, bool useIndex_ = true)
+        : path(path_), useIndex(useIndex_), dominatorsReady(false) {}
     
     ~TaskHeapSnapshot() = default;
     
-    bool parseSnapshot();
-    std::vector<ReferenceChain> getShortestPathToGCRoot(int nodeId, int maxDepth = 5);
-    std::vector<ReferenceChain> getShortestPathToGCRootByName(const std::string& nodeName, int maxDepth = 5);
+    // monitor不为空时上报解析进度，取消后返回false
+    bool parseSnapshot(AnalysisMonitor* monitor = nullptr);
+    // monitor不为空时在BFS中检查取消，取消后返回空链
+    std::vector<ReferenceChain> getShortestPathToGCRoot(uint64_t nodeId, int maxDepth = 5,
+                                                        AnalysisMonitor* monitor = nullptr);
+    std::vector<ReferenceChain> getShortestPathToGCRootByName(const std::string& nodeName, int maxDepth = 5,
+                                                              AnalysisMonitor* monitor = nullptr);
+    
+    // 计算支配树和保留大小，首次查询保留大小时自动调用；monitor不为空时计入dominators阶段
+    void computeDominatorTree(AnalysisMonitor* monitor = nullptr);
+    bool getRetainedInfo(uint64_t nodeId, RetainedInfo& info);
+    // withRetained为false时不计算支配树，retained_size和dominator_id为0
+    bool getRetainedInfoByName(const std::string& nodeName, RetainedInfo& info, bool withRetained = true);
+    
+    // 按id升序输出堆对象及其self_size + native_size，跳过合成根节点和id为0的hash节点；
+    // 分组名与rawheap输入相同，见rawheap_translate::HeapObjects::ClassName
+    void collectObjects(rawheap_translate::HeapObjects& objects) const;
+    
+    // 估算常驻的堆内存，映射的sidecar索引由页缓存管理不计入；支配树还没有计算时按计算后的大小预留
+    size_t memoryUsage() const;
     
 private:
+    bool parseJson(AnalysisMonitor* monitor);
+    bool loadIndex();
+    bool validateIndex() const;
+    bool loadDominators(const SnapshotIndexReader& reader);
+    void saveIndex() const;
     void parseMetaAndData();
+    void buildStringTable();
+    void buildNodeIdIndex();
     void buildReferences();
+    void buildGCRootFlags();
+    void buildHashIndex();
+    void buildRootDistances();
+    void buildPostOrder(std::vector<int>& postOrderToNode, std::vector<int>& nodeToPostOrder) const;
+    void fillRetainedInfo(int nodeIndex, RetainedInfo& info, bool withRetained);
     std::string getStringById(int id) const;
-    void parseNodeNameAndPath(HeapNode& node, const std::string& originalName);
-    HeapNode* findHashNodeByName(const std::string& targetName);
+    int findNodeIndexById(uint64_t nodeId) const;
+    std::vector<ReferenceChain> getShortestPathToGCRootByIndex(int targetNodeIndex, int maxDepth,
+                                                               AnalysisMonitor* monitor);
+    int findStringId(const std::string& str) const;
+    bool stringEquals(int id, const char* str, size_t length) const;
+    void parseNodeNameAndPath(ReferenceChainNode& node, const std::string& originalName) const;
+    ReferenceChainNode makeChainNode(int nodeIndex) const;
+    int findHashNodeIndexByName(const std::string& targetName) const;
+    
+    // CSR形式的图：节点i的出边为 edges[firstEdgeIndexes[i], firstEdgeIndexes[i + 1])，
+    // 引用者为 retainingNodes/retainingEdges[firstRetainerIndexes[i], firstRetainerIndexes[i + 1])
+    IndexArray<int> firstEdgeIndexes;
+    IndexArray<int> firstRetainerIndexes;
+    IndexArray<int> retainingNodes;
+    IndexArray<int> retainingEdges;
     
-    // 内部数据结构
-    std::vector<int> nodesRaw;
+    // GC根标记，BFS只做查表
+    IndexArray<uint8_t> gcRootFlags;
+    
+    // 从根节点(索引0)沿非弱引用边的BFS距离，不可达节点为-1
+    IndexArray<int32_t> rootDistances;
+    
+    // 从sidecar索引加载时持有映射内存，上面的数组直接指向其中的数据段
+    std::unique_ptr<SnapshotIndexReader> indexReader;
+    
+    // 支配树：节点索引 -> 直接支配者的节点索引，不可达节点为-1；计算后写入sidecar索引，再次打开时直接映射
+    IndexArray<int> dominators;
+    IndexArray<uint64_t> retainedSizes;
+    bool dominatorsReady;
+    std::mutex dominatorMutex;
+    
+    // 内部数据结构，仅在解析JSON期间使用
+    std::vector<std::string> parsedStrings;
+    std::vector<int64_t> nodesRaw;
     std::vector<int> edgesRaw;
+    std::vector<int64_t> hashIndexRaw;  // rawheap转换时不生成hash节点时的(hash, 节点索引)对
     struct Meta {
         std::vector<std::string> node_fields;
         std::vector<std::string> edge_fields;
@@ -121,16 +220,36 @@ private:
     friend class TaskHeapSnapshotHandler;
 };
 
-// 全局任务管理
+// 全局任务管理，可在多个线程中调用
+// 解析过的快照按路径缓存，快照文件大小和修改时间不变时直接复用，超出内存预算时淘汰最久未使用的快照
 class TaskManager {
 private:
-    static std::map<int, std::unique_ptr<TaskHeapSnapshot>> tasks;
+    struct CacheEntry {
+        std::string path;
+        SnapshotFileStamp stamp;
+        std::shared_ptr<TaskHeapSnapshot> snapshot;
+        size_t bytes;
+    };
+    
+    static std::mutex mutex;
+    static std::map<int, std::shared_ptr<TaskHeapSnapshot>> tasks;
     static int nextTaskId;
+    static std::list<CacheEntry> cache;  // 最近使用的在前
+    static size_t cacheBytes;
+    static size_t cacheBudget;
+    
+    static std::shared_ptr<TaskHeapSnapshot> findCached(const std::string& path, const SnapshotFileStamp& stamp);
+    static void addToCache(const std::string& path, const SnapshotFileStamp& stamp,
+                           const std::shared_ptr<TaskHeapSnapshot>& snapshot);
+    static void trimCache();
     
 public:
-    static int createTask(const std::string& path);
-    static TaskHeapSnapshot* getTask(int id);
+    // useIndex为false时用于临时快照：不写sidecar索引，也不进入缓存
+    static int createTask(const std::string& path, bool useIndex = true, AnalysisMonitor* monitor = nullptr);
+    static std::shared_ptr<TaskHeapSnapshot> getTask(int id);
     static bool destroyTask(int id);
+    // 设置缓存的内存预算（字节），为0时不缓存
+    static void setCacheBudget(size_t bytes);
 };
 
 #endif // HEAP_SNAPSHOT_PARSER_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+# 主机侧工具共用的分析器静态库：编译除NAPI入口以外的全部源码，供benchmark和cli使用
+if(NOT TARGET leakguard_core)
+    set(CMAKE_CXX_STANDARD 17)
+    set(CMAKE_CXX_STANDARD_REQUIRED ON)
+    if(NOT CMAKE_BUILD_TYPE)
+        set(CMAKE_BUILD_TYPE Release)
+    endif()
+
+    # 分析器源码目录与第三方库路径，可在配置时覆盖
+    get_filename_component(LEAKGUARD_SRC_DIR ${CMAKE_CURRENT_LIST_DIR} ABSOLUTE)
+    get_filename_component(LEAKGUARD_ROOT_DIR ${LEAKGUARD_SRC_DIR}/../../../.. ABSOLUTE)
+    set(RAPIDJSON_INCLUDE_DIRS ${LEAKGUARD_ROOT_DIR}/rapidjson/include CACHE PATH "rapidjson include directory")
+    set(LIB_BOUNDS_CHECK_DIR ${LEAKGUARD_ROOT_DIR}/libboundscheck CACHE PATH "libboundscheck directory")
+
+    file(GLOB LIB_BOUNDS_CHECK_SOURCES "${LIB_BOUNDS_CHECK_DIR}/src/*.c")
+
+    # 分析器源码，排除NAPI模块入口
+    file(GLOB ANALYZER_SOURCES "${LEAKGUARD_SRC_DIR}/*.cpp")
+    list(REMOVE_ITEM ANALYZER_SOURCES "${LEAKGUARD_SRC_DIR}/napi_init.cpp")
+
+    add_library(leakguard_core STATIC
+        ${ANALYZER_SOURCES}
+        ${LIB_BOUNDS_CHECK_SOURCES}
+    )
+    target_include_directories(leakguard_core PUBLIC
+        ${RAPIDJSON_INCLUDE_DIRS}
+        ${LIB_BOUNDS_CHECK_DIR}/include
+        ${LEAKGUARD_SRC_DIR}
+    )
+
+    find_package(Threads REQUIRED)
+    target_link_libraries(leakguard_core PUBLIC Threads::Threads)
+endif()
@@ -31,9 +31,9 @@ bool MetaParser::Parse(const rapidjson::Value &object)
     return true;
 }
 
-JSType MetaParser::GetJSTypeFromHClass(Node *hclass)
+JSType MetaParser::GetJSTypeFromHClass(char *hclassData)
 {
-    JSType type = static_cast<JSType>(ByteToU32(hclass->data + bitField_.objectTypeField.offset));
+    JSType type = static_cast<JSType>(ByteToU32(hclassData + bitField_.objectTypeField.offset));
     if (type < orderedMeta_.size()) {
         // lower 8-bits of 32-bit value means JSType
         return type;
@@ -60,12 +60,12 @@ NodeType MetaParser::GetNodeType(JSType type)
     return meta->nodeType;
 }
 
-uint32_t MetaParser::GetNativateSize(Node *node, JSType type)
+uint32_t MetaParser::GetNativateSize(char *data, JSType type)
 {
     if (!IsNativePointer(type)) {
         return 0;
     }
-    return ByteToU32(node->data + bitField_.nativePointerBindingSizeField.offset);
+    return ByteToU32(data + bitField_.nativePointerBindingSizeField.offset);
 }
 
 std::string MetaParser::GetTypeName(JSType type)
@@ -34,10 +34,10 @@ public:
     }
 
     bool Parse(const rapidjson::Value &object);
-    JSType GetJSTypeFromHClass(Node *hclass);
+    JSType GetJSTypeFromHClass(char *hclassData);
     JSType GetJSTypeFromTypeName(const std::string &name);
     NodeType GetNodeType(JSType type);
-    uint32_t GetNativateSize(Node *node, JSType type);
+    uint32_t GetNativateSize(char *data, JSType type);
     std::string GetTypeName(JSType type);
     MetaData* GetMetaData(const std::string &name);
     MetaData* GetMetaData(const JSType type);
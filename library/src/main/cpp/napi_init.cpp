@@ -4,17 +4,250 @@
 #include <thread>
 #include <future>
 #include <cstdio>
+#include <functional>
+#include <memory>
 #include "napi/native_api.h"
 // 声明而非包含heap_snapshot_parser.cpp
 #include "heap_snapshot_parser.h"
 #include "rawheap_translate.h"
+#include "packed_result.h"
+#include "worker_pool.h"
+#include "hash_analysis.h"
+#include "heap_diff.h"
 
 // 实现NAPI接口
 
+// JS Number能精确表示的最大整数 2^53 - 1
+static constexpr uint64_t MAX_SAFE_INTEGER = 9007199254740991ULL;
+
+// 创建节点ID，安全整数范围内返回number，超出时返回BigInt
+static napi_value createNodeId(napi_env env, uint64_t id) {
+    napi_value result = nullptr;
+    if (id <= MAX_SAFE_INTEGER) {
+        napi_create_int64(env, static_cast<int64_t>(id), &result);
+    } else {
+        napi_create_bigint_uint64(env, id, &result);
+    }
+    return result;
+}
+
+// 解析number或BigInt形式的节点ID
+static bool getNodeId(napi_env env, napi_value value, uint64_t &id) {
+    napi_valuetype valueType;
+    if (napi_typeof(env, value, &valueType) != napi_ok) {
+        return false;
+    }
+    if (valueType == napi_bigint) {
+        bool lossless = false;
+        return napi_get_value_bigint_uint64(env, value, &id, &lossless) == napi_ok;
+    }
+    int64_t number = 0;
+    if (napi_get_value_int64(env, value, &number) != napi_ok || number < 0) {
+        return false;
+    }
+    id = static_cast<uint64_t>(number);
+    return true;
+}
+
+// 读取字符串参数
+static bool getStringValue(napi_env env, napi_value value, std::string &str) {
+    size_t length = 0;
+    if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) {
+        return false;
+    }
+    str.resize(length + 1);
+    if (napi_get_value_string_utf8(env, value, &str[0], length + 1, nullptr) != napi_ok) {
+        return false;
+    }
+    str.resize(length);
+    return true;
+}
+
+// 创建引用链节点对象
+static napi_value createChainNodeObject(napi_env env, const ReferenceChainNode &node) {
+    napi_value nodeObj;
+    napi_create_object(env, &nodeObj);
+
+    napi_value nodeId = createNodeId(env, node.id);
+    napi_set_named_property(env, nodeObj, "nodeId", nodeId);
+
+    napi_value name;
+    napi_create_string_utf8(env, node.name.c_str(), node.name.length(), &name);
+    napi_set_named_property(env, nodeObj, "name", name);
+
+    napi_value type;
+    napi_create_string_utf8(env, node.type.c_str(), node.type.length(), &type);
+    napi_set_named_property(env, nodeObj, "type", type);
+
+    // 处理path字段，可能为空字符串
+    napi_value path;
+    napi_create_string_utf8(env, node.path.c_str(), node.path.length(), &path);
+    napi_set_named_property(env, nodeObj, "path", path);
+
+    // 处理line字段，可能为0
+    napi_value line;
+    napi_create_int32(env, node.line, &line);
+    napi_set_named_property(env, nodeObj, "line", line);
+
+    return nodeObj;
+}
+
+// 将引用链转换为NAPI数组
+static napi_value createReferenceChainArray(napi_env env, const std::vector<ReferenceChain> &chains) {
+    napi_value result;
+    napi_create_array_with_length(env, chains.size(), &result);
+
+    for (size_t i = 0; i < chains.size(); i++) {
+        const ReferenceChain &refChain = chains[i];
+        napi_value chainObj;
+        napi_create_object(env, &chainObj);
+
+        napi_set_named_property(env, chainObj, "from", createChainNodeObject(env, refChain.referrer));
+
+        napi_value edgeType;
+        napi_create_string_utf8(env, refChain.edge_type.c_str(), refChain.edge_type.length(), &edgeType);
+        napi_set_named_property(env, chainObj, "edgeType", edgeType);
+
+        napi_set_named_property(env, chainObj, "to", createChainNodeObject(env, refChain.current_node));
+
+        napi_set_element(env, result, i, chainObj);
+    }
+    return result;
+}
+
+// 把紧凑编码的结果转交给ArrayBuffer，不再复制
+static napi_value createPackedArrayBuffer(napi_env env, std::vector<uint8_t> &&packed) {
+    std::vector<uint8_t> *buffer = new std::vector<uint8_t>(std::move(packed));
+    napi_value result = nullptr;
+    napi_status status = napi_create_external_arraybuffer(env, buffer->data(), buffer->size(),
+        [](napi_env env, void *data, void *hint) { delete static_cast<std::vector<uint8_t> *>(hint); }, buffer,
+        &result);
+    if (status != napi_ok) {
+        delete buffer;
+        return nullptr;
+    }
+    return result;
+}
+
+// 把一次调用的统计转换为NAPI对象
+static napi_value createStatsObject(napi_env env, const StatsSnapshot &stats) {
+    napi_value result;
+    napi_create_object(env, &result);
+
+    napi_value call;
+    napi_create_string_utf8(env, stats.call.c_str(), stats.call.length(), &call);
+    napi_set_named_property(env, result, "call", call);
+
+    napi_value timestamp;
+    napi_create_double(env, static_cast<double>(stats.timestampMs), &timestamp);
+    napi_set_named_property(env, result, "timestamp", timestamp);
+
+    napi_value rssKb;
+    napi_create_double(env, static_cast<double>(stats.rssKb), &rssKb);
+    napi_set_named_property(env, result, "rssKb", rssKb);
+
+    napi_value rssDeltaKb;
+    napi_create_double(env, static_cast<double>(stats.rssDeltaKb), &rssDeltaKb);
+    napi_set_named_property(env, result, "rssDeltaKb", rssDeltaKb);
+
+    napi_value phases;
+    napi_create_array_with_length(env, stats.phases.size(), &phases);
+    for (size_t i = 0; i < stats.phases.size(); i++) {
+        const PhaseStats &phase = stats.phases[i];
+        napi_value phaseObj;
+        napi_create_object(env, &phaseObj);
+
+        napi_value name;
+        napi_create_string_utf8(env, phase.name.c_str(), phase.name.length(), &name);
+        napi_set_named_property(env, phaseObj, "name", name);
+
+        napi_value calls;
+        napi_create_double(env, static_cast<double>(phase.calls), &calls);
+        napi_set_named_property(env, phaseObj, "calls", calls);
+
+        // 时间以毫秒返回
+        napi_value wallMs;
+        napi_create_double(env, static_cast<double>(phase.wallNs) / 1e6, &wallMs);
+        napi_set_named_property(env, phaseObj, "wallMs", wallMs);
+
+        napi_value cpuMs;
+        napi_create_double(env, static_cast<double>(phase.cpuNs) / 1e6, &cpuMs);
+        napi_set_named_property(env, phaseObj, "cpuMs", cpuMs);
+
+        napi_value items;
+        napi_create_double(env, static_cast<double>(phase.items), &items);
+        napi_set_named_property(env, phaseObj, "items", items);
+
+        napi_value bytes;
+        napi_create_double(env, static_cast<double>(phase.bytes), &bytes);
+        napi_set_named_property(env, phaseObj, "bytes", bytes);
+
+        napi_set_element(env, phases, i, phaseObj);
+    }
+    napi_set_named_property(env, result, "phases", phases);
+    return result;
+}
+
+// 读取options.onStats并创建引用，没有设置时返回nullptr
+static napi_ref createStatsCallbackRef(napi_env env, napi_value options) {
+    napi_valuetype optionsType = napi_undefined;
+    if (options == nullptr || napi_typeof(env, options, &optionsType) != napi_ok || optionsType != napi_object) {
+        return nullptr;
+    }
+    napi_value onStats;
+    napi_valuetype callbackType = napi_undefined;
+    napi_ref callbackRef = nullptr;
+    if (napi_get_named_property(env, options, "onStats", &onStats) == napi_ok &&
+        napi_typeof(env, onStats, &callbackType) == napi_ok && callbackType == napi_function &&
+        napi_create_reference(env, onStats, 1, &callbackRef) != napi_ok) {
+        callbackRef = nullptr;
+    }
+    return callbackRef;
+}
+
+// 在JS线程中把本次调用的统计交给onStats并释放引用，与getLastStats不同，不受同时进行的其他调用影响
+static void callStatsCallback(napi_env env, napi_ref &callbackRef, const StatsSnapshot &stats) {
+    if (callbackRef == nullptr) {
+        return;
+    }
+    napi_value onStats;
+    if (!stats.call.empty() && napi_get_reference_value(env, callbackRef, &onStats) == napi_ok &&
+        onStats != nullptr) {
+        napi_value statsObj = createStatsObject(env, stats);
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, onStats, 1, &statsObj, nullptr);
+    }
+    napi_delete_reference(env, callbackRef);
+    callbackRef = nullptr;
+}
+
+// 保存本次调用的分阶段统计，供getLastStats查询；只在JS线程中调用，返回的统计可以再交给onStats
+static StatsSnapshot publishStats(AnalysisMonitor &monitor, const char *call) {
+    StatsSnapshot stats = monitor.getStats().snapshot(call);
+    AnalysisStats::publish(stats);
+    return stats;
+}
+
+// 同步调用结束时发布统计，并交给调用选项中的onStats
+static void publishCallStats(napi_env env, AnalysisMonitor &monitor, const char *call, napi_value options) {
+    napi_ref callbackRef = createStatsCallbackRef(env, options);
+    callStatsCallback(env, callbackRef, publishStats(monitor, call));
+}
+
+// 读取可选的整数参数，未传或为undefined时保留默认值
+static bool getOptionalInt32(napi_env env, napi_value value, int32_t &result) {
+    napi_valuetype valueType = napi_undefined;
+    if (value == nullptr || (napi_typeof(env, value, &valueType) == napi_ok && valueType == napi_undefined)) {
+        return true;
+    }
+    return napi_get_value_int32(env, value, &result) == napi_ok;
+}
+
 // 创建任务
 static napi_value CreateTask(napi_env env, napi_callback_info info) {
-    size_t argc = 1;
-    napi_value args[1] = {nullptr};
+    size_t argc = 2;
+    napi_value args[2] = {nullptr, nullptr};
 
     // 获取参数
     if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
@@ -42,7 +275,9 @@ static napi_value CreateTask(napi_env env, napi_callback_info info) {
     delete[] filePathBuffer;
 
     // 创建任务
-    int taskId = TaskManager::createTask(filePath);
+    AnalysisMonitor monitor;
+    int taskId = TaskManager::createTask(filePath, true, &monitor);
+    publishCallStats(env, monitor, "createTask", args[1]);
 
     // 返回任务ID
     napi_value result;
@@ -80,10 +315,93 @@ static napi_value DestroyTask(napi_env env, napi_callback_info info) {
     return result;
 }
 
+// 设置已解析快照缓存的内存预算
+static napi_value SetSnapshotCacheBudget(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+
+    if (argc < 1) {
+        napi_throw_error(env, nullptr, "需要一个参数: 内存预算(字节)");
+        return nullptr;
+    }
+
+    int64_t bytes = 0;
+    if (napi_get_value_int64(env, args[0], &bytes) != napi_ok) {
+        return nullptr;
+    }
+
+    TaskManager::setCacheBudget(bytes > 0 ? static_cast<size_t>(bytes) : 0);
+    return nullptr;
+}
+
+// 配置转换和分析共用的工作线程池：{maxThreads?: number, background?: boolean}
+static napi_value ConfigureWorkerPool(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+
+    int32_t maxThreads = 0;
+    bool background = false;
+    napi_valuetype optionsType = napi_undefined;
+    if (argc >= 1 && napi_typeof(env, args[0], &optionsType) == napi_ok && optionsType == napi_object) {
+        napi_value value;
+        napi_valuetype valueType = napi_undefined;
+        if (napi_get_named_property(env, args[0], "maxThreads", &value) == napi_ok &&
+            napi_typeof(env, value, &valueType) == napi_ok && valueType == napi_number) {
+            napi_get_value_int32(env, value, &maxThreads);
+        }
+        valueType = napi_undefined;
+        if (napi_get_named_property(env, args[0], "background", &value) == napi_ok &&
+            napi_typeof(env, value, &valueType) == napi_ok && valueType == napi_boolean) {
+            napi_get_value_bool(env, value, &background);
+        }
+    }
+
+    WorkerPool::instance().configure(maxThreads > 0 ? static_cast<size_t>(maxThreads) : 0, background);
+    return nullptr;
+}
+
+// 获取JS线程中最近完成的一次调用的分阶段统计，还没有调用过时返回undefined；
+// 只在同步调用刚返回时可靠，有异步调用进行中时请用各调用的options.onStats
+static napi_value GetLastStats(napi_env env, napi_callback_info info) {
+    StatsSnapshot stats;
+    if (!AnalysisStats::getLast(stats)) {
+        return nullptr;
+    }
+    return createStatsObject(env, stats);
+}
+
+// 设置统计输出文件，每次调用结束后追加一行JSON；为空字符串时不输出
+static napi_value SetStatsDumpPath(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 1) {
+        napi_throw_error(env, nullptr, "需要一个参数: 输出文件路径");
+        return nullptr;
+    }
+
+    std::string path;
+    if (!getStringValue(env, args[0], path)) {
+        return nullptr;
+    }
+    AnalysisStats::setDumpPath(path);
+    return nullptr;
+}
+
 // 获取最短引用链到GC根
 static napi_value GetShortestPathToGCRoot(napi_env env, napi_callback_info info) {
-    size_t argc = 3;
-    napi_value args[3] = {nullptr, nullptr, nullptr};
+    size_t argc = 4;
+    napi_value args[4] = {nullptr, nullptr, nullptr, nullptr};
 
     // 获取参数
     if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
@@ -118,111 +436,131 @@ static napi_value GetShortestPathToGCRoot(napi_env env, napi_callback_info info)
 
     // 解析最大路径数参数
     int32_t maxDepth = 5; // 默认最大路径数
-    if (argc >= 3) {
-        if (napi_get_value_int32(env, args[2], &maxDepth) != napi_ok) {
-            return nullptr;
-        }
+    if (!getOptionalInt32(env, args[2], maxDepth)) {
+        return nullptr;
     }
 
     // 获取任务
-    TaskHeapSnapshot *task = TaskManager::getTask(taskId);
+    std::shared_ptr<TaskHeapSnapshot> task = TaskManager::getTask(taskId);
     if (!task) {
         napi_throw_error(env, nullptr, "无效的任务ID");
         return nullptr;
     }
 
     // 查找最短引用链
-    std::vector<ReferenceChain> resultChains = task->getShortestPathToGCRootByName(nodeName, maxDepth);
+    AnalysisMonitor monitor;
+    std::vector<ReferenceChain> resultChains = task->getShortestPathToGCRootByName(nodeName, maxDepth, &monitor);
+    publishCallStats(env, monitor, "getShortestPathToGCRoot", args[3]);
 
     // 将结果转换为NAPI数组
-    napi_value result;
-    napi_create_array_with_length(env, resultChains.size(), &result);
+    return createReferenceChainArray(env, resultChains);
+}
 
-    for (size_t i = 0; i < resultChains.size(); i++) {
-        const ReferenceChain &refChain = resultChains[i];
-        // 创建链对象
-        napi_value chainObj;
-        napi_create_object(env, &chainObj);
+// 获取最短引用链到GC根，结果为紧凑编码的ArrayBuffer
+static napi_value GetShortestPathToGCRootPacked(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4] = {nullptr, nullptr, nullptr, nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 2) {
+        napi_throw_error(env, nullptr, "需要两个参数: 任务ID和节点ID");
+        return nullptr;
+    }
 
-        // 设置引用者信息
-        napi_value referrerObj;
-        napi_create_object(env, &referrerObj);
-
-        napi_value referrerNodeId;
-        napi_create_int32(env, refChain.referrer.id, &referrerNodeId);
-        napi_set_named_property(env, referrerObj, "nodeId", referrerNodeId);
-
-        napi_value referrerName;
-        napi_create_string_utf8(env, refChain.referrer.name.c_str(), refChain.referrer.name.length(), &referrerName);
-        napi_set_named_property(env, referrerObj, "name", referrerName);
-
-        napi_value referrerType;
-        napi_create_string_utf8(env, refChain.referrer.type.c_str(), refChain.referrer.type.length(), &referrerType);
-        napi_set_named_property(env, referrerObj, "type", referrerType);
-
-        // 处理path字段，可能为空字符串
-        napi_value referrerPath;
-        napi_create_string_utf8(env, refChain.referrer.path.c_str(), refChain.referrer.path.length(), &referrerPath);
-        napi_set_named_property(env, referrerObj, "path", referrerPath);
-
-        // 处理line字段，可能为0
-        napi_value referrerLine;
-        napi_create_int32(env, refChain.referrer.line, &referrerLine);
-        napi_set_named_property(env, referrerObj, "line", referrerLine);
-
-        // 设置引用者
-        napi_set_named_property(env, chainObj, "from", referrerObj);
-
-        // 设置edgeType
-        napi_value edgeTypeVal;
-        napi_create_string_utf8(env, refChain.edge_type.c_str(), refChain.edge_type.length(), &edgeTypeVal);
-        napi_set_named_property(env, chainObj, "edgeType", edgeTypeVal);
-
-        // 设置被引用者信息
-        napi_value currentNodeObj;
-        napi_create_object(env, &currentNodeObj);
-
-        // 设置nodeId
-        napi_value currentNodeId;
-        napi_create_int32(env, refChain.current_node.id, &currentNodeId);
-        napi_set_named_property(env, currentNodeObj, "nodeId", currentNodeId);
-
-        // 设置name
-        napi_value currentNodeName;
-        napi_create_string_utf8(env, refChain.current_node.name.c_str(), refChain.current_node.name.length(),
-                                &currentNodeName);
-        napi_set_named_property(env, currentNodeObj, "name", currentNodeName);
-
-        // 设置type
-        napi_value currentNodeType;
-        napi_create_string_utf8(env, refChain.current_node.type.c_str(), refChain.current_node.type.length(),
-                                &currentNodeType);
-        napi_set_named_property(env, currentNodeObj, "type", currentNodeType);
-
-        // 处理path字段，可能为空字符串
-        napi_value currentNodePath;
-        napi_create_string_utf8(env, refChain.current_node.path.c_str(), refChain.current_node.path.length(),
-                                &currentNodePath);
-        napi_set_named_property(env, currentNodeObj, "path", currentNodePath);
-
-        // 处理line字段，可能为0
-        napi_value currentNodeLine;
-        napi_create_int32(env, refChain.current_node.line, &currentNodeLine);
-        napi_set_named_property(env, currentNodeObj, "line", currentNodeLine);
-
-        // 设置被引用者
-        napi_set_named_property(env, chainObj, "to", currentNodeObj);
-
-        // 将链对象添加到链数组
-        napi_set_element(env, result, i, chainObj);
+    int32_t taskId = 0;
+    if (napi_get_value_int32(env, args[0], &taskId) != napi_ok) {
+        return nullptr;
+    }
+    std::string nodeName;
+    if (!getStringValue(env, args[1], nodeName)) {
+        return nullptr;
+    }
+    int32_t maxDepth = 5; // 默认最大路径数
+    if (!getOptionalInt32(env, args[2], maxDepth)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<TaskHeapSnapshot> task = TaskManager::getTask(taskId);
+    if (!task) {
+        napi_throw_error(env, nullptr, "无效的任务ID");
+        return nullptr;
+    }
+
+    AnalysisMonitor monitor;
+    PackedResultWriter writer;
+    writer.addTarget(0, nodeName, 0, 0, task->getShortestPathToGCRootByName(nodeName, maxDepth, &monitor));
+    publishCallStats(env, monitor, "getShortestPathToGCRootPacked", args[3]);
+    return createPackedArrayBuffer(env, writer.finish());
+}
+
+// 获取节点的保留大小和直接支配者
+static napi_value GetRetainedInfo(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr, nullptr};
+
+    // 获取参数
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+
+    if (argc < 2) {
+        napi_throw_error(env, nullptr, "需要两个参数: 任务ID和节点ID");
+        return nullptr;
+    }
+
+    // 解析任务ID参数
+    int32_t taskId = 0;
+    if (napi_get_value_int32(env, args[0], &taskId) != napi_ok) {
+        return nullptr;
+    }
+
+    // 解析节点ID参数
+    uint64_t nodeId = 0;
+    if (!getNodeId(env, args[1], nodeId)) {
+        napi_throw_error(env, nullptr, "无效的节点ID");
+        return nullptr;
+    }
+
+    // 获取任务
+    std::shared_ptr<TaskHeapSnapshot> task = TaskManager::getTask(taskId);
+    if (!task) {
+        napi_throw_error(env, nullptr, "无效的任务ID");
+        return nullptr;
     }
 
+    RetainedInfo retainedInfo;
+    if (!task->getRetainedInfo(nodeId, retainedInfo)) {
+        return nullptr;
+    }
+
+    napi_value result;
+    napi_create_object(env, &result);
+
+    napi_value nodeIdVal = createNodeId(env, retainedInfo.id);
+    napi_set_named_property(env, result, "nodeId", nodeIdVal);
+
+    napi_value selfSize;
+    napi_create_double(env, static_cast<double>(retainedInfo.self_size), &selfSize);
+    napi_set_named_property(env, result, "selfSize", selfSize);
+
+    napi_value retainedSize;
+    napi_create_double(env, static_cast<double>(retainedInfo.retained_size), &retainedSize);
+    napi_set_named_property(env, result, "retainedSize", retainedSize);
+
+    napi_value dominatorId = createNodeId(env, retainedInfo.dominator_id);
+    napi_set_named_property(env, result, "dominatorId", dominatorId);
+
+    napi_value distance;
+    napi_create_int32(env, retainedInfo.distance, &distance);
+    napi_set_named_property(env, result, "distance", distance);
+
     return result;
 }
 
 static napi_value rawHeapTranslate(napi_env env, napi_callback_info info) {
-    size_t argc = 2;
-    napi_value args[2] = {nullptr};
+    size_t argc = 3;
+    napi_value args[3] = {nullptr, nullptr, nullptr};
 
     // 获取参数
     if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
@@ -264,77 +602,28 @@ static napi_value rawHeapTranslate(napi_env env, napi_callback_info info) {
     std::string outFilePath(outFilePathBuffer);
     delete[] outFilePathBuffer;
 
-    rawheap_translate::RawHeap::TranslateRawheap(inFilePath, outFilePath);
+    AnalysisMonitor monitor;
+    rawheap_translate::RawHeap::TranslateRawheap(inFilePath, outFilePath, &monitor);
+    publishCallStats(env, monitor, "rawHeapTranslate", args[2]);
 
     return nullptr;
 }
 
-// 定义NodeRef结构体用于存储结果
-struct NodeRef {
-    int hash;
-    std::string name;
-    std::vector<ReferenceChain> refs;
-};
-
-// 定义异步任务的数据结构
-struct RawAnalyzeHashAsyncData {
-    napi_env env;
-    napi_async_work work;
-    napi_deferred deferred;
-    std::string file;
-    std::vector<std::pair<std::string, int>> nodeInfos;
-    std::vector<NodeRef> result;
+// 通用Promise异步任务：execute在工作线程执行并填写本次调用的统计，complete在JS线程把结果转换为NAPI值
+struct PromiseAsyncData {
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+    std::function<void(std::string &error, StatsSnapshot &stats)> execute;
+    std::function<napi_value(napi_env env)> complete;
     std::string error;
+    StatsSnapshot stats;
+    napi_ref statsCallback = nullptr;  // options.onStats
 };
 
-static void heapAnalyzeHashExecute(napi_env env, void *data) {
-    RawAnalyzeHashAsyncData *asyncData = static_cast<RawAnalyzeHashAsyncData *>(data);
-    // 创建任务
-    int taskId = TaskManager::createTask(asyncData->file);
-    if (taskId == -1) {
-        asyncData->error = "创建任务失败";
-        return;
-    }
-    try {
-        // 处理每个节点信息
-        for (const auto &nodeInfo : asyncData->nodeInfos) {
-            std::string nodeName = "Int:" + std::to_string(nodeInfo.second);
-            std::vector<ReferenceChain> refChains =
-                TaskManager::getTask(taskId)->getShortestPathToGCRootByName(nodeName, 10);
-
-            if (!refChains.empty()) {
-                NodeRef nodeRef;
-                nodeRef.hash = nodeInfo.second;
-                nodeRef.name = nodeInfo.first;
-                nodeRef.refs = refChains;
-                asyncData->result.push_back(nodeRef);
-            }
-        }
-
-        // 销毁任务
-        TaskManager::destroyTask(taskId);
-    } catch (...) {
-        TaskManager::destroyTask(taskId);
-        throw;
-    }
-}
-
-// 异步任务执行函数
-static void RawAnalyzeHashExecute(napi_env env, void *data) {
-    RawAnalyzeHashAsyncData *asyncData = static_cast<RawAnalyzeHashAsyncData *>(data);
-
+static void promiseWorkExecute(napi_env env, void *data) {
+    PromiseAsyncData *asyncData = static_cast<PromiseAsyncData *>(data);
     try {
-        // 转换rawheap文件为heapsnapshot
-        std::string heapsnapshotFile = asyncData->file;
-        size_t pos = heapsnapshotFile.rfind(".rawheap");
-        if (pos != std::string::npos) {
-            heapsnapshotFile.replace(pos, 8, ".heapsnapshot");
-        }
-
-        rawheap_translate::RawHeap::TranslateRawheap(asyncData->file, heapsnapshotFile);
-        asyncData->file = heapsnapshotFile;
-        heapAnalyzeHashExecute(env, asyncData);
-        remove(heapsnapshotFile.c_str());
+        asyncData->execute(asyncData->error, asyncData->stats);
     } catch (const std::exception &e) {
         asyncData->error = e.what();
     } catch (...) {
@@ -342,46 +631,452 @@ static void RawAnalyzeHashExecute(napi_env env, void *data) {
     }
 }
 
-// 辅助函数：解析函数参数
-static bool parseAnalyzeHashParams(napi_env env, napi_callback_info info, std::string &filePath, std::vector<std::pair<std::string, int>> &nodeInfos) {
-    size_t argc = 2;
-    napi_value args[2] = {nullptr};
-
-    // 获取参数
-    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
-        return false;
+static void promiseWorkComplete(napi_env env, napi_status status, void *data) {
+    PromiseAsyncData *asyncData = static_cast<PromiseAsyncData *>(data);
+    if (status != napi_ok && asyncData->error.empty()) {
+        asyncData->error = "异步任务被取消";
     }
-
-    if (argc < 2) {
-        napi_throw_error(env, nullptr, "需要两个参数: 文件路径和节点信息数组");
-        return false;
+    // 统计在JS线程中发布，getLastStats不会被工作线程中途改写
+    if (!asyncData->stats.call.empty()) {
+        AnalysisStats::publish(asyncData->stats);
     }
-
-    // 解析文件路径参数
-    size_t filePathLength = 0;
-    if (napi_get_value_string_utf8(env, args[0], nullptr, 0, &filePathLength) != napi_ok) {
-        return false;
+    callStatsCallback(env, asyncData->statsCallback, asyncData->stats);
+    if (!asyncData->error.empty()) {
+        napi_value error;
+        napi_create_string_utf8(env, asyncData->error.c_str(), asyncData->error.length(), &error);
+        napi_reject_deferred(env, asyncData->deferred, error);
+    } else {
+        napi_value result = asyncData->complete ? asyncData->complete(env) : nullptr;
+        if (result == nullptr) {
+            napi_get_undefined(env, &result);
+        }
+        napi_resolve_deferred(env, asyncData->deferred, result);
     }
+    napi_delete_async_work(env, asyncData->work);
+    delete asyncData;
+}
 
-    char *filePathBuffer = new char[filePathLength + 1];
-    if (napi_get_value_string_utf8(env, args[0], filePathBuffer, filePathLength + 1, nullptr) != napi_ok) {
-        delete[] filePathBuffer;
-        return false;
+// 创建Promise并把execute排队到工作线程，execute通过error参数报告失败；options.onStats用于接收本次调用的统计
+static napi_value queuePromiseWork(napi_env env, const char *resourceNameStr,
+                                   std::function<void(std::string &error, StatsSnapshot &stats)> execute,
+                                   std::function<napi_value(napi_env env)> complete, napi_value options = nullptr) {
+    PromiseAsyncData *asyncData = new PromiseAsyncData();
+    asyncData->execute = std::move(execute);
+    asyncData->complete = std::move(complete);
+
+    napi_value promise;
+    if (napi_create_promise(env, &asyncData->deferred, &promise) != napi_ok) {
+        delete asyncData;
+        return nullptr;
     }
 
-    filePath = std::string(filePathBuffer);
-    delete[] filePathBuffer;
+    napi_value resourceName;
+    napi_create_string_utf8(env, resourceNameStr, NAPI_AUTO_LENGTH, &resourceName);
+    if (napi_create_async_work(env, nullptr, resourceName, promiseWorkExecute, promiseWorkComplete, asyncData,
+                               &asyncData->work) != napi_ok) {
+        napi_reject_deferred(env, asyncData->deferred, nullptr);
+        delete asyncData;
+        return nullptr;
+    }
+    if (napi_queue_async_work(env, asyncData->work) != napi_ok) {
+        napi_delete_async_work(env, asyncData->work);
+        napi_reject_deferred(env, asyncData->deferred, nullptr);
+        delete asyncData;
+        return nullptr;
+    }
+    // 排队成功后才创建引用，失败路径不必释放；complete在之后的JS线程事件中执行
+    asyncData->statsCallback = createStatsCallbackRef(env, options);
+    return promise;
+}
 
-    // 解析节点信息数组
+// 异步创建任务，快照在工作线程中解析
+static napi_value CreateTaskAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr, nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 1) {
+        napi_throw_error(env, nullptr, "需要一个参数: 文件路径");
+        return nullptr;
+    }
+
+    std::string filePath;
+    if (!getStringValue(env, args[0], filePath)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<int> taskId = std::make_shared<int>(-1);
+    return queuePromiseWork(env, "CreateTaskAsync",
+        [filePath, taskId](std::string &error, StatsSnapshot &stats) {
+            AnalysisMonitor monitor;
+            *taskId = TaskManager::createTask(filePath, true, &monitor);
+            stats = monitor.getStats().snapshot("createTaskAsync");
+            if (*taskId == -1) {
+                error = "创建任务失败";
+            }
+        },
+        [taskId](napi_env env) {
+            napi_value result;
+            napi_create_int32(env, *taskId, &result);
+            return result;
+        },
+        args[1]);
+}
+
+// 异步查询到GC根的最短引用链
+static napi_value GetShortestPathToGCRootAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4] = {nullptr, nullptr, nullptr, nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 2) {
+        napi_throw_error(env, nullptr, "需要两个参数: 任务ID和节点ID");
+        return nullptr;
+    }
+
+    int32_t taskId = 0;
+    if (napi_get_value_int32(env, args[0], &taskId) != napi_ok) {
+        return nullptr;
+    }
+    std::string nodeName;
+    if (!getStringValue(env, args[1], nodeName)) {
+        return nullptr;
+    }
+    int32_t maxDepth = 5; // 默认最大路径数
+    if (!getOptionalInt32(env, args[2], maxDepth)) {
+        return nullptr;
+    }
+
+    // 在JS线程取得快照引用，执行期间任务被销毁也不影响查询
+    std::shared_ptr<TaskHeapSnapshot> task = TaskManager::getTask(taskId);
+    if (!task) {
+        napi_throw_error(env, nullptr, "无效的任务ID");
+        return nullptr;
+    }
+
+    std::shared_ptr<std::vector<ReferenceChain>> chains = std::make_shared<std::vector<ReferenceChain>>();
+    return queuePromiseWork(env, "GetShortestPathToGCRootAsync",
+        [task, nodeName, maxDepth, chains](std::string &error, StatsSnapshot &stats) {
+            AnalysisMonitor monitor;
+            *chains = task->getShortestPathToGCRootByName(nodeName, maxDepth, &monitor);
+            stats = monitor.getStats().snapshot("getShortestPathToGCRootAsync");
+        },
+        [chains](napi_env env) {
+            return createReferenceChainArray(env, *chains);
+        },
+        args[3]);
+}
+
+// 异步把rawheap转换为heapsnapshot
+static napi_value RawHeapTranslateAsync(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr, nullptr, nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 2) {
+        napi_throw_error(env, nullptr, "需要两个参数: 输入文件路径和输出文件路径");
+        return nullptr;
+    }
+
+    std::string inFilePath;
+    std::string outFilePath;
+    if (!getStringValue(env, args[0], inFilePath) || !getStringValue(env, args[1], outFilePath)) {
+        return nullptr;
+    }
+
+    return queuePromiseWork(env, "RawHeapTranslateAsync",
+        [inFilePath, outFilePath](std::string &error, StatsSnapshot &stats) {
+            AnalysisMonitor monitor;
+            if (!rawheap_translate::RawHeap::TranslateRawheap(inFilePath, outFilePath, &monitor)) {
+                error = "转换rawheap失败";
+            }
+            stats = monitor.getStats().snapshot("rawHeapTranslateAsync");
+        },
+        nullptr, args[2]);
+}
+
+// CancelToken：ArkTS侧持有的取消令牌，包装一个可跨线程共享的取消标记
+static napi_value CancelTokenConstructor(napi_env env, napi_callback_info info) {
+    napi_value thisArg = nullptr;
+    if (napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    CancelFlag *flag = new CancelFlag(std::make_shared<std::atomic<bool>>(false));
+    napi_status status = napi_wrap(env, thisArg, flag,
+        [](napi_env env, void *data, void *hint) { delete static_cast<CancelFlag *>(data); }, nullptr, nullptr);
+    if (status != napi_ok) {
+        delete flag;
+        return nullptr;
+    }
+    return thisArg;
+}
+
+// 取出CancelToken中的取消标记，不是CancelToken时返回nullptr
+static CancelFlag getCancelFlag(napi_env env, napi_value token) {
+    void *data = nullptr;
+    if (napi_unwrap(env, token, &data) != napi_ok || data == nullptr) {
+        return nullptr;
+    }
+    return *static_cast<CancelFlag *>(data);
+}
+
+static napi_value CancelTokenCancel(napi_env env, napi_callback_info info) {
+    napi_value thisArg = nullptr;
+    if (napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    CancelFlag flag = getCancelFlag(env, thisArg);
+    if (flag) {
+        flag->store(true);
+    }
+    return nullptr;
+}
+
+static napi_value CancelTokenIsCancelled(napi_env env, napi_callback_info info) {
+    napi_value thisArg = nullptr;
+    if (napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    CancelFlag flag = getCancelFlag(env, thisArg);
+    napi_value result;
+    napi_get_boolean(env, flag && flag->load(), &result);
+    return result;
+}
+
+// 在JS线程中把进度转换为对象并调用onProgress
+static void callProgressJs(napi_env env, napi_value jsCallback, void *context, void *data) {
+    AnalysisProgress *progress = static_cast<AnalysisProgress *>(data);
+    if (env != nullptr && jsCallback != nullptr) {
+        napi_value progressObj;
+        napi_create_object(env, &progressObj);
+
+        napi_value phase;
+        napi_create_string_utf8(env, progress->phase.c_str(), progress->phase.length(), &phase);
+        napi_set_named_property(env, progressObj, "phase", phase);
+
+        napi_value bytes;
+        napi_create_double(env, static_cast<double>(progress->bytes), &bytes);
+        napi_set_named_property(env, progressObj, "bytes", bytes);
+
+        napi_value totalBytes;
+        napi_create_double(env, static_cast<double>(progress->totalBytes), &totalBytes);
+        napi_set_named_property(env, progressObj, "totalBytes", totalBytes);
+
+        napi_value nodes;
+        napi_create_double(env, static_cast<double>(progress->nodes), &nodes);
+        napi_set_named_property(env, progressObj, "nodes", nodes);
+
+        napi_value edges;
+        napi_create_double(env, static_cast<double>(progress->edges), &edges);
+        napi_set_named_property(env, progressObj, "edges", edges);
+
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, jsCallback, 1, &progressObj, nullptr);
+    }
+    delete progress;
+}
+
+// 把NodeRef转换为NAPI对象
+static napi_value createNodeRefObject(napi_env env, const NodeRef &nodeRef) {
+    napi_value nodeRefObj;
+    napi_create_object(env, &nodeRefObj);
+
+    // 设置hash
+    napi_value hash;
+    napi_create_int32(env, nodeRef.hash, &hash);
+    napi_set_named_property(env, nodeRefObj, "hash", hash);
+
+    // 设置name
+    napi_value name;
+    napi_create_string_utf8(env, nodeRef.name.c_str(), nodeRef.name.length(), &name);
+    napi_set_named_property(env, nodeRefObj, "name", name);
+
+    // 设置自身大小和保留大小
+    napi_value selfSize;
+    napi_create_double(env, static_cast<double>(nodeRef.selfSize), &selfSize);
+    napi_set_named_property(env, nodeRefObj, "selfSize", selfSize);
+
+    napi_value retainedSize;
+    napi_create_double(env, static_cast<double>(nodeRef.retainedSize), &retainedSize);
+    napi_set_named_property(env, nodeRefObj, "retainedSize", retainedSize);
+
+    // 设置ref数组
+    napi_value refArray = createReferenceChainArray(env, nodeRef.refs);
+    napi_set_named_property(env, nodeRefObj, "ref", refArray);
+    return nodeRefObj;
+}
+
+// 在JS线程中把单个目标的结果转换为对象并调用onResult
+static void callResultJs(napi_env env, napi_value jsCallback, void *context, void *data) {
+    NodeRef *nodeRef = static_cast<NodeRef *>(data);
+    if (env != nullptr && jsCallback != nullptr) {
+        napi_value nodeRefObj = createNodeRefObject(env, *nodeRef);
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, jsCallback, 1, &nodeRefObj, nullptr);
+    }
+    delete nodeRef;
+}
+
+// 在JS线程中把单个目标的紧凑编码交给onPackedResult，不创建NodeRef对象
+static void callPackedResultJs(napi_env env, napi_value jsCallback, void *context, void *data) {
+    std::vector<uint8_t> *fragment = static_cast<std::vector<uint8_t> *>(data);
+    if (env != nullptr && jsCallback != nullptr) {
+        napi_value buffer = createPackedArrayBuffer(env, std::move(*fragment));
+        if (buffer != nullptr) {
+            napi_value undefined;
+            napi_get_undefined(env, &undefined);
+            napi_call_function(env, undefined, jsCallback, 1, &buffer, nullptr);
+        }
+    }
+    delete fragment;
+}
+
+// 定义异步任务的数据结构
+struct RawAnalyzeHashAsyncData {
+    napi_env env;
+    napi_async_work work;
+    napi_deferred deferred;
+    std::string file;
+    std::vector<std::pair<std::string, int>> nodeInfos;
+    std::vector<NodeRef> result;
+    std::string error;
+    bool useIndex = true;  // 临时转换出的快照用完即删，不写sidecar索引
+    napi_threadsafe_function progressFn = nullptr;
+    // onResult(packed时为onPackedResult)，每找到一个目标的引用链就回调一次
+    napi_threadsafe_function resultFn = nullptr;
+    std::unique_ptr<AnalysisMonitor> monitor;
+    const char *callName = "";
+    bool packed = false;  // 为true时结果以紧凑编码的ArrayBuffer返回
+    std::vector<uint8_t> packedResult;
+    bool quickCheck = false;  // 先扫描rawheap对象表，只转换和查询存在的目标
+    napi_ref statsCallback = nullptr;  // options.onStats
+};
+
+// 释放异步数据，已排队的进度和结果回调仍会在回调函数释放前执行
+static void deleteAnalyzeAsyncData(RawAnalyzeHashAsyncData *asyncData) {
+    if (asyncData->progressFn != nullptr) {
+        napi_release_threadsafe_function(asyncData->progressFn, napi_tsfn_release);
+    }
+    if (asyncData->resultFn != nullptr) {
+        napi_release_threadsafe_function(asyncData->resultFn, napi_tsfn_release);
+    }
+    if (asyncData->statsCallback != nullptr) {
+        napi_delete_reference(asyncData->env, asyncData->statsCallback);
+    }
+    delete asyncData;
+}
+
+static void heapAnalyzeHashExecute(napi_env env, void *data) {
+    RawAnalyzeHashAsyncData *asyncData = static_cast<RawAnalyzeHashAsyncData *>(data);
+    // 创建任务
+    AnalysisMonitor *monitor = asyncData->monitor.get();
+    int taskId = TaskManager::createTask(asyncData->file, asyncData->useIndex, monitor);
+    if (taskId == -1) {
+        asyncData->error = monitor->isCancelled() ? ANALYSIS_CANCELED : "创建任务失败";
+        return;
+    }
+    std::shared_ptr<TaskHeapSnapshot> task = TaskManager::getTask(taskId);
+    try {
+        NodeRefCallback onResult = nullptr;
+        if (asyncData->resultFn != nullptr) {
+            // 先把这个目标推给回调，不必等整批查询结束；packed时在工作线程中编码成只含这个目标的片段
+            onResult = [asyncData](const NodeRef &nodeRef) {
+                void *streamed = nullptr;
+                if (asyncData->packed) {
+                    PackedResultWriter writer;
+                    writer.addTarget(nodeRef.hash, nodeRef.name, nodeRef.selfSize, nodeRef.retainedSize,
+                                     nodeRef.refs);
+                    streamed = new std::vector<uint8_t>(writer.finish());
+                } else {
+                    streamed = new NodeRef(nodeRef);
+                }
+                if (napi_call_threadsafe_function(asyncData->resultFn, streamed, napi_tsfn_nonblocking) != napi_ok) {
+                    if (asyncData->packed) {
+                        delete static_cast<std::vector<uint8_t> *>(streamed);
+                    } else {
+                        delete static_cast<NodeRef *>(streamed);
+                    }
+                }
+            };
+        }
+        asyncData->result = analyzeHashTargets(*task, asyncData->nodeInfos, 10, monitor, onResult);
+        if (monitor->isCancelled()) {
+            asyncData->error = ANALYSIS_CANCELED;
+        }
+
+        // 在工作线程中完成编码，JS线程只需创建ArrayBuffer
+        if (asyncData->packed && asyncData->error.empty()) {
+            PackedResultWriter writer;
+            for (const NodeRef &nodeRef : asyncData->result) {
+                writer.addTarget(nodeRef.hash, nodeRef.name, nodeRef.selfSize, nodeRef.retainedSize, nodeRef.refs);
+            }
+            asyncData->packedResult = writer.finish();
+            asyncData->result.clear();
+        }
+
+        // 销毁任务
+        TaskManager::destroyTask(taskId);
+    } catch (...) {
+        TaskManager::destroyTask(taskId);
+        throw;
+    }
+}
+
+// 异步任务执行函数
+static void RawAnalyzeHashExecute(napi_env env, void *data) {
+    RawAnalyzeHashAsyncData *asyncData = static_cast<RawAnalyzeHashAsyncData *>(data);
+
+    try {
+        // 快速检查：目标都不在rawheap中时直接返回空结果，不必转换
+        std::vector<std::pair<std::string, int>> present;
+        if (asyncData->quickCheck &&
+            filterPresentTargets(asyncData->file, asyncData->nodeInfos, present, asyncData->monitor.get())) {
+            asyncData->nodeInfos = std::move(present);
+            if (asyncData->nodeInfos.empty()) {
+                if (asyncData->packed) {
+                    asyncData->packedResult = PackedResultWriter().finish();
+                }
+                return;
+            }
+        }
+
+        // 转换rawheap文件为heapsnapshot
+        std::string heapsnapshotFile = snapshotPathForRawheap(asyncData->file);
+
+        // 临时快照只供本次分析，hash写入索引而不生成数值节点
+        if (!rawheap_translate::RawHeap::TranslateRawheap(asyncData->file, heapsnapshotFile,
+                                                          asyncData->monitor.get(), false)) {
+            remove(heapsnapshotFile.c_str());
+            asyncData->error = asyncData->monitor->isCancelled() ? ANALYSIS_CANCELED : "转换rawheap失败";
+            return;
+        }
+        asyncData->file = heapsnapshotFile;
+        asyncData->useIndex = false;
+        heapAnalyzeHashExecute(env, asyncData);
+        remove(heapsnapshotFile.c_str());
+    } catch (const std::exception &e) {
+        asyncData->error = e.what();
+    } catch (...) {
+        asyncData->error = "未知错误";
+    }
+}
+
+// 解析HashInfo数组
+static bool parseHashInfoArray(napi_env env, napi_value array, std::vector<std::pair<std::string, int>> &nodeInfos) {
     uint32_t arrayLength = 0;
-    if (napi_get_array_length(env, args[1], &arrayLength) != napi_ok) {
+    if (napi_get_array_length(env, array, &arrayLength) != napi_ok) {
         napi_throw_error(env, nullptr, "解析节点信息数组失败");
         return false;
     }
 
     for (uint32_t i = 0; i < arrayLength; i++) {
         napi_value nodeInfoObj;
-        if (napi_get_element(env, args[1], i, &nodeInfoObj) != napi_ok) {
+        if (napi_get_element(env, array, i, &nodeInfoObj) != napi_ok) {
             napi_throw_error(env, nullptr, "获取节点信息失败");
             return false;
         }
@@ -428,9 +1123,46 @@ static bool parseAnalyzeHashParams(napi_env env, napi_callback_info info, std::s
     return true;
 }
 
+// 辅助函数：解析函数参数
+static bool parseAnalyzeHashParams(napi_env env, napi_callback_info info, std::string &filePath,
+                                   std::vector<std::pair<std::string, int>> &nodeInfos, napi_value &options) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+
+    // 获取参数
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return false;
+    }
+
+    if (argc < 2) {
+        napi_throw_error(env, nullptr, "需要两个参数: 文件路径和节点信息数组");
+        return false;
+    }
+    options = argc >= 3 ? args[2] : nullptr;
+
+    // 解析文件路径参数
+    size_t filePathLength = 0;
+    if (napi_get_value_string_utf8(env, args[0], nullptr, 0, &filePathLength) != napi_ok) {
+        return false;
+    }
+
+    char *filePathBuffer = new char[filePathLength + 1];
+    if (napi_get_value_string_utf8(env, args[0], filePathBuffer, filePathLength + 1, nullptr) != napi_ok) {
+        delete[] filePathBuffer;
+        return false;
+    }
+
+    filePath = std::string(filePathBuffer);
+    delete[] filePathBuffer;
+
+    // 解析节点信息数组
+    return parseHashInfoArray(env, args[1], nodeInfos);
+}
+
 // 异步任务完成回调
 static void RawAnalyzeHashComplete(napi_env env, napi_status status, void *data) {
     RawAnalyzeHashAsyncData *asyncData = static_cast<RawAnalyzeHashAsyncData *>(data);
+    callStatsCallback(env, asyncData->statsCallback, publishStats(*asyncData->monitor, asyncData->callName));
 
     napi_value result;
     if (!asyncData->error.empty()) {
@@ -438,109 +1170,16 @@ static void RawAnalyzeHashComplete(napi_env env, napi_status status, void *data)
         napi_value error;
         napi_create_string_utf8(env, asyncData->error.c_str(), asyncData->error.length(), &error);
         napi_reject_deferred(env, asyncData->deferred, error);
+    } else if (asyncData->packed) {
+        result = createPackedArrayBuffer(env, std::move(asyncData->packedResult));
+        napi_resolve_deferred(env, asyncData->deferred, result);
     } else {
         // 解析结果为NAPI对象
         napi_create_array_with_length(env, asyncData->result.size(), &result);
 
         for (size_t i = 0; i < asyncData->result.size(); i++) {
-            const NodeRef &nodeRef = asyncData->result[i];
-
-            // 创建NodeRef对象
-            napi_value nodeRefObj;
-            napi_create_object(env, &nodeRefObj);
-
-            // 设置hash
-            napi_value hash;
-            napi_create_int32(env, nodeRef.hash, &hash);
-            napi_set_named_property(env, nodeRefObj, "hash", hash);
-
-            // 设置name
-            napi_value name;
-            napi_create_string_utf8(env, nodeRef.name.c_str(), nodeRef.name.length(), &name);
-            napi_set_named_property(env, nodeRefObj, "name", name);
-
-            // 设置ref数组
-            napi_value refArray;
-            napi_create_array_with_length(env, nodeRef.refs.size(), &refArray);
-
-            for (size_t j = 0; j < nodeRef.refs.size(); j++) {
-                const ReferenceChain &refChain = nodeRef.refs[j];
-
-                // 创建ReferenceChain对象
-                napi_value refChainObj;
-                napi_create_object(env, &refChainObj);
-
-                // 设置from
-                napi_value fromObj;
-                napi_create_object(env, &fromObj);
-
-                napi_value fromNodeId;
-                napi_create_int32(env, refChain.referrer.id, &fromNodeId);
-                napi_set_named_property(env, fromObj, "nodeId", fromNodeId);
-
-                napi_value fromName;
-                napi_create_string_utf8(env, refChain.referrer.name.c_str(), refChain.referrer.name.length(),
-                                        &fromName);
-                napi_set_named_property(env, fromObj, "name", fromName);
-
-                napi_value fromType;
-                napi_create_string_utf8(env, refChain.referrer.type.c_str(), refChain.referrer.type.length(),
-                                        &fromType);
-                napi_set_named_property(env, fromObj, "type", fromType);
-
-                napi_value fromPath;
-                napi_create_string_utf8(env, refChain.referrer.path.c_str(), refChain.referrer.path.length(),
-                                        &fromPath);
-                napi_set_named_property(env, fromObj, "path", fromPath);
-
-                napi_value fromLine;
-                napi_create_int32(env, refChain.referrer.line, &fromLine);
-                napi_set_named_property(env, fromObj, "line", fromLine);
-
-                napi_set_named_property(env, refChainObj, "from", fromObj);
-
-                // 设置edgeType
-                napi_value edgeType;
-                napi_create_string_utf8(env, refChain.edge_type.c_str(), refChain.edge_type.length(), &edgeType);
-                napi_set_named_property(env, refChainObj, "edgeType", edgeType);
-
-                // 设置to
-                napi_value toObj;
-                napi_create_object(env, &toObj);
-
-                napi_value toNodeId;
-                napi_create_int32(env, refChain.current_node.id, &toNodeId);
-                napi_set_named_property(env, toObj, "nodeId", toNodeId);
-
-                napi_value toName;
-                napi_create_string_utf8(env, refChain.current_node.name.c_str(), refChain.current_node.name.length(),
-                                        &toName);
-                napi_set_named_property(env, toObj, "name", toName);
-
-                napi_value toType;
-                napi_create_string_utf8(env, refChain.current_node.type.c_str(), refChain.current_node.type.length(),
-                                        &toType);
-                napi_set_named_property(env, toObj, "type", toType);
-
-                napi_value toPath;
-                napi_create_string_utf8(env, refChain.current_node.path.c_str(), refChain.current_node.path.length(),
-                                        &toPath);
-                napi_set_named_property(env, toObj, "path", toPath);
-
-                napi_value toLine;
-                napi_create_int32(env, refChain.current_node.line, &toLine);
-                napi_set_named_property(env, toObj, "line", toLine);
-
-                napi_set_named_property(env, refChainObj, "to", toObj);
-
-                // 添加到ref数组
-                napi_set_element(env, refArray, j, refChainObj);
-            }
-
-            napi_set_named_property(env, nodeRefObj, "ref", refArray);
-
             // 添加到结果数组
-            napi_set_element(env, result, i, nodeRefObj);
+            napi_set_element(env, result, i, createNodeRefObject(env, asyncData->result[i]));
         }
 
         // 解决Promise
@@ -549,25 +1188,113 @@ static void RawAnalyzeHashComplete(napi_env env, napi_status status, void *data)
 
     // 清理资源
     napi_delete_async_work(env, asyncData->work);
-    delete asyncData;
+    deleteAnalyzeAsyncData(asyncData);
+}
+
+// 读取选项对象中的布尔属性，不存在或类型不符时返回false
+static bool getBoolOption(napi_env env, napi_value options, const char *name) {
+    napi_valuetype optionsType = napi_undefined;
+    if (options == nullptr || napi_typeof(env, options, &optionsType) != napi_ok || optionsType != napi_object) {
+        return false;
+    }
+    napi_value value;
+    napi_valuetype valueType = napi_undefined;
+    bool result = false;
+    if (napi_get_named_property(env, options, name, &value) == napi_ok &&
+        napi_typeof(env, value, &valueType) == napi_ok && valueType == napi_boolean) {
+        napi_get_value_bool(env, value, &result);
+    }
+    return result;
+}
+
+// 读取选项对象中的数值属性，不存在或类型不符时返回false且不修改value
+static bool getDoubleOption(napi_env env, napi_value options, const char *name, double &value) {
+    napi_valuetype optionsType = napi_undefined;
+    if (options == nullptr || napi_typeof(env, options, &optionsType) != napi_ok || optionsType != napi_object) {
+        return false;
+    }
+    napi_value property;
+    napi_valuetype valueType = napi_undefined;
+    return napi_get_named_property(env, options, name, &property) == napi_ok &&
+           napi_typeof(env, property, &valueType) == napi_ok && valueType == napi_number &&
+           napi_get_value_double(env, property, &value) == napi_ok;
+}
+
+// 解析分析选项：cancelToken用于取消，onProgress用于接收进度，resultKey对应的回调用于逐个接收结果
+static bool setupAnalyzeOptions(napi_env env, napi_value options, const char *resultKey,
+                                napi_threadsafe_function_call_js resultCallJs, napi_threadsafe_function &progressFn,
+                                napi_threadsafe_function &resultFn, std::unique_ptr<AnalysisMonitor> &monitor) {
+    CancelFlag cancelFlag;
+    AnalysisMonitor::ProgressCallback callback;
+    napi_valuetype optionsType = napi_undefined;
+    if (options != nullptr && napi_typeof(env, options, &optionsType) == napi_ok && optionsType == napi_object) {
+        napi_value token;
+        if (napi_get_named_property(env, options, "cancelToken", &token) == napi_ok) {
+            cancelFlag = getCancelFlag(env, token);
+        }
+
+        napi_value onProgress;
+        napi_valuetype callbackType = napi_undefined;
+        if (napi_get_named_property(env, options, "onProgress", &onProgress) == napi_ok &&
+            napi_typeof(env, onProgress, &callbackType) == napi_ok && callbackType == napi_function) {
+            napi_value resourceName;
+            napi_create_string_utf8(env, "AnalyzeProgress", NAPI_AUTO_LENGTH, &resourceName);
+            if (napi_create_threadsafe_function(env, onProgress, nullptr, resourceName, 0, 1, nullptr, nullptr,
+                                                nullptr, callProgressJs, &progressFn) != napi_ok) {
+                return false;
+            }
+            napi_threadsafe_function progressTsfn = progressFn;
+            callback = [progressTsfn](const AnalysisProgress &progress) {
+                AnalysisProgress *data = new AnalysisProgress(progress);
+                if (napi_call_threadsafe_function(progressTsfn, data, napi_tsfn_nonblocking) != napi_ok) {
+                    delete data;
+                }
+            };
+        }
+
+        napi_value onResult;
+        callbackType = napi_undefined;
+        if (napi_get_named_property(env, options, resultKey, &onResult) == napi_ok &&
+            napi_typeof(env, onResult, &callbackType) == napi_ok && callbackType == napi_function) {
+            napi_value resourceName;
+            napi_create_string_utf8(env, "AnalyzeResult", NAPI_AUTO_LENGTH, &resourceName);
+            if (napi_create_threadsafe_function(env, onResult, nullptr, resourceName, 0, 1, nullptr, nullptr,
+                                                nullptr, resultCallJs, &resultFn) != napi_ok) {
+                return false;
+            }
+        }
+    }
+    monitor = std::make_unique<AnalysisMonitor>(cancelFlag, callback);
+    return true;
 }
 
 
 // 辅助函数：创建和启动异步工作
 static napi_value createAndStartAsyncWork(napi_env env, const std::string &filePath, 
-                                          std::vector<std::pair<std::string, int>> &&nodeInfos,
+                                          std::vector<std::pair<std::string, int>> &&nodeInfos, napi_value options,
                                           napi_async_execute_callback executeFunc,
-                                          const char *resourceNameStr) {
+                                          const char *resourceNameStr, bool packed) {
     // 创建异步数据
     RawAnalyzeHashAsyncData *asyncData = new RawAnalyzeHashAsyncData();
     asyncData->env = env;
     asyncData->file = filePath;
     asyncData->nodeInfos = std::move(nodeInfos);
+    asyncData->packed = packed;
+    asyncData->callName = resourceNameStr;
+    asyncData->quickCheck = getBoolOption(env, options, "quickCheck");
+    // packed调用的结果本身就是紧凑编码，逐个推送时也只传片段
+    if (!setupAnalyzeOptions(env, options, packed ? "onPackedResult" : "onResult",
+                             packed ? callPackedResultJs : callResultJs, asyncData->progressFn, asyncData->resultFn,
+                             asyncData->monitor)) {
+        deleteAnalyzeAsyncData(asyncData);
+        return nullptr;
+    }
+    asyncData->statsCallback = createStatsCallbackRef(env, options);
 
     // 创建Promise
     napi_value promise;
     if (napi_create_promise(env, &asyncData->deferred, &promise) != napi_ok) {
-        delete asyncData;
+        deleteAnalyzeAsyncData(asyncData);
         return nullptr;
     }
 
@@ -578,7 +1305,7 @@ static napi_value createAndStartAsyncWork(napi_env env, const std::string &fileP
     if (napi_create_async_work(env, nullptr, resourceName, executeFunc, RawAnalyzeHashComplete, asyncData,
                                &asyncData->work) != napi_ok) {
         napi_reject_deferred(env, asyncData->deferred, nullptr);
-        delete asyncData;
+        deleteAnalyzeAsyncData(asyncData);
         return nullptr;
     }
 
@@ -586,52 +1313,496 @@ static napi_value createAndStartAsyncWork(napi_env env, const std::string &fileP
     if (napi_queue_async_work(env, asyncData->work) != napi_ok) {
         napi_delete_async_work(env, asyncData->work);
         napi_reject_deferred(env, asyncData->deferred, nullptr);
-        delete asyncData;
+        deleteAnalyzeAsyncData(asyncData);
         return nullptr;
     }
 
     return promise;
 }
 
-// 异步rawAnalyzeHash函数
-static napi_value RawAnalyzeHash(napi_env env, napi_callback_info info) {
+// 解析参数并启动分析
+static napi_value startAnalyzeHash(napi_env env, napi_callback_info info, napi_async_execute_callback executeFunc,
+                                   const char *resourceNameStr, bool packed) {
     std::string filePath;
     std::vector<std::pair<std::string, int>> nodeInfos;
 
     // 解析参数
-    if (!parseAnalyzeHashParams(env, info, filePath, nodeInfos)) {
+    napi_value options = nullptr;
+    if (!parseAnalyzeHashParams(env, info, filePath, nodeInfos, options)) {
         return nullptr;
     }
 
     // 创建并启动异步工作
-    return createAndStartAsyncWork(env, filePath, std::move(nodeInfos), RawAnalyzeHashExecute, "RawAnalyzeHashAsync");
+    return createAndStartAsyncWork(env, filePath, std::move(nodeInfos), options, executeFunc, resourceNameStr, packed);
+}
+
+// 异步rawAnalyzeHash函数
+static napi_value RawAnalyzeHash(napi_env env, napi_callback_info info) {
+    return startAnalyzeHash(env, info, RawAnalyzeHashExecute, "RawAnalyzeHashAsync", false);
 }
 
 static napi_value HeapAnalyzeHash(napi_env env, napi_callback_info info) {
-    std::string filePath;
-    std::vector<std::pair<std::string, int>> nodeInfos;
+    return startAnalyzeHash(env, info, heapAnalyzeHashExecute, "HeapAnalyzeHashAsync", false);
+}
 
-    // 解析参数
-    if (!parseAnalyzeHashParams(env, info, filePath, nodeInfos)) {
+// 结果以紧凑编码的ArrayBuffer返回的版本
+static napi_value RawAnalyzeHashPacked(napi_env env, napi_callback_info info) {
+    return startAnalyzeHash(env, info, RawAnalyzeHashExecute, "RawAnalyzeHashPackedAsync", true);
+}
+
+static napi_value HeapAnalyzeHashPacked(napi_env env, napi_callback_info info) {
+    return startAnalyzeHash(env, info, heapAnalyzeHashExecute, "HeapAnalyzeHashPackedAsync", true);
+}
+
+static void setDoubleProperty(napi_env env, napi_value object, const char *name, uint64_t value) {
+    napi_value number;
+    napi_create_double(env, static_cast<double>(value), &number);
+    napi_set_named_property(env, object, name, number);
+}
+
+static void setStringProperty(napi_env env, napi_value object, const char *name, const std::string &value) {
+    napi_value str;
+    napi_create_string_utf8(env, value.c_str(), value.length(), &str);
+    napi_set_named_property(env, object, name, str);
+}
+
+static napi_value createSummaryEntryArray(napi_env env, const std::vector<rawheap_translate::SummaryEntry> &entries,
+                                          bool sampled) {
+    napi_value array;
+    napi_create_array_with_length(env, entries.size(), &array);
+    for (size_t i = 0; i < entries.size(); i++) {
+        napi_value entry;
+        napi_create_object(env, &entry);
+        setStringProperty(env, entry, "name", entries[i].name);
+        setDoubleProperty(env, entry, "count", entries[i].count);
+        setDoubleProperty(env, entry, "selfSize", entries[i].selfSize);
+        setDoubleProperty(env, entry, "nativeSize", entries[i].nativeSize);
+        // 误差只在抽样时给出
+        if (sampled) {
+            setDoubleProperty(env, entry, "countError", entries[i].countError);
+            setDoubleProperty(env, entry, "selfSizeError", entries[i].selfSizeError);
+            setDoubleProperty(env, entry, "nativeSizeError", entries[i].nativeSizeError);
+        }
+        napi_set_element(env, array, i, entry);
+    }
+    return array;
+}
+
+static napi_value createHeapSummaryObject(napi_env env, const rawheap_translate::HeapSummary &summary) {
+    bool sampled = summary.sampleRate < 1;
+    napi_value result;
+    napi_create_object(env, &result);
+    napi_value sampleRate;
+    napi_create_double(env, summary.sampleRate, &sampleRate);
+    napi_set_named_property(env, result, "sampleRate", sampleRate);
+    setDoubleProperty(env, result, "sampledCount", summary.sampledCount);
+    setDoubleProperty(env, result, "objectCount", summary.objectCount);
+    setDoubleProperty(env, result, "selfSize", summary.selfSize);
+    setDoubleProperty(env, result, "nativeSize", summary.nativeSize);
+    if (sampled) {
+        setDoubleProperty(env, result, "objectCountError", summary.objectCountError);
+        setDoubleProperty(env, result, "selfSizeError", summary.selfSizeError);
+        setDoubleProperty(env, result, "nativeSizeError", summary.nativeSizeError);
+    }
+    napi_set_named_property(env, result, "types", createSummaryEntryArray(env, summary.types, sampled));
+    napi_set_named_property(env, result, "names", createSummaryEntryArray(env, summary.names, sampled));
+
+    napi_value targets;
+    napi_create_array_with_length(env, summary.targets.size(), &targets);
+    for (size_t i = 0; i < summary.targets.size(); i++) {
+        const rawheap_translate::SummaryTarget &item = summary.targets[i];
+        napi_value target;
+        napi_create_object(env, &target);
+        napi_value hash;
+        napi_create_int32(env, static_cast<int32_t>(item.hash), &hash);
+        napi_set_named_property(env, target, "hash", hash);
+        napi_set_named_property(env, target, "nodeId", createNodeId(env, item.nodeId));
+        setStringProperty(env, target, "type", item.type);
+        setStringProperty(env, target, "name", item.name);
+        setDoubleProperty(env, target, "selfSize", item.selfSize);
+        setDoubleProperty(env, target, "nativeSize", item.nativeSize);
+        napi_set_element(env, targets, i, target);
+    }
+    napi_set_named_property(env, result, "targets", targets);
+    return result;
+}
+
+// 批量分析的异步数据
+struct BatchAnalyzeAsyncData {
+    napi_env env;
+    napi_async_work work;
+    napi_deferred deferred;
+    std::vector<DumpAnalysisJob> jobs;
+    DumpAnalysisOptions options;
+    std::vector<DumpAnalysisResult> results;
+    std::string error;
+    napi_threadsafe_function progressFn = nullptr;
+    napi_threadsafe_function dumpResultFn = nullptr;  // onDumpResult，每完成一个dump回调一次
+    std::unique_ptr<AnalysisMonitor> monitor;
+    napi_ref statsCallback = nullptr;  // options.onStats
+};
+
+static void deleteBatchAsyncData(BatchAnalyzeAsyncData *asyncData) {
+    if (asyncData->progressFn != nullptr) {
+        napi_release_threadsafe_function(asyncData->progressFn, napi_tsfn_release);
+    }
+    if (asyncData->dumpResultFn != nullptr) {
+        napi_release_threadsafe_function(asyncData->dumpResultFn, napi_tsfn_release);
+    }
+    if (asyncData->statsCallback != nullptr) {
+        napi_delete_reference(asyncData->env, asyncData->statsCallback);
+    }
+    delete asyncData;
+}
+
+// 把单个dump的结果转换为NAPI对象
+static napi_value createDumpResultObject(napi_env env, const DumpAnalysisResult &result) {
+    napi_value resultObj;
+    napi_create_object(env, &resultObj);
+
+    napi_value filePath;
+    napi_create_string_utf8(env, result.file.c_str(), result.file.length(), &filePath);
+    napi_set_named_property(env, resultObj, "filePath", filePath);
+
+    if (!result.error.empty()) {
+        napi_value error;
+        napi_create_string_utf8(env, result.error.c_str(), result.error.length(), &error);
+        napi_set_named_property(env, resultObj, "error", error);
+    }
+
+    napi_value refs;
+    napi_create_array_with_length(env, result.refs.size(), &refs);
+    for (size_t i = 0; i < result.refs.size(); i++) {
+        napi_set_element(env, refs, i, createNodeRefObject(env, result.refs[i]));
+    }
+    napi_set_named_property(env, resultObj, "refs", refs);
+    if (result.summary.sampledCount > 0) {
+        napi_set_named_property(env, resultObj, "summary", createHeapSummaryObject(env, result.summary));
+    }
+    return resultObj;
+}
+
+// 在JS线程中把单个dump的结果转换为对象并调用onDumpResult
+static void callDumpResultJs(napi_env env, napi_value jsCallback, void *context, void *data) {
+    DumpAnalysisResult *result = static_cast<DumpAnalysisResult *>(data);
+    if (env != nullptr && jsCallback != nullptr) {
+        napi_value resultObj = createDumpResultObject(env, *result);
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, jsCallback, 1, &resultObj, nullptr);
+    }
+    delete result;
+}
+
+static void AnalyzeDumpBatchExecute(napi_env env, void *data) {
+    BatchAnalyzeAsyncData *asyncData = static_cast<BatchAnalyzeAsyncData *>(data);
+    try {
+        DumpResultCallback onDump = nullptr;
+        if (asyncData->dumpResultFn != nullptr) {
+            onDump = [asyncData](size_t index, const DumpAnalysisResult &result) {
+                DumpAnalysisResult *streamed = new DumpAnalysisResult(result);
+                if (napi_call_threadsafe_function(asyncData->dumpResultFn, streamed, napi_tsfn_nonblocking) !=
+                    napi_ok) {
+                    delete streamed;
+                }
+            };
+        }
+        asyncData->results = analyzeDumpBatch(asyncData->jobs, asyncData->options, asyncData->monitor.get(), onDump);
+        if (asyncData->monitor->isCancelled()) {
+            asyncData->error = ANALYSIS_CANCELED;
+        }
+    } catch (const std::exception &e) {
+        asyncData->error = e.what();
+    } catch (...) {
+        asyncData->error = "未知错误";
+    }
+}
+
+static void AnalyzeDumpBatchComplete(napi_env env, napi_status status, void *data) {
+    BatchAnalyzeAsyncData *asyncData = static_cast<BatchAnalyzeAsyncData *>(data);
+    callStatsCallback(env, asyncData->statsCallback, publishStats(*asyncData->monitor, "AnalyzeDumpBatchAsync"));
+
+    if (!asyncData->error.empty()) {
+        napi_value error;
+        napi_create_string_utf8(env, asyncData->error.c_str(), asyncData->error.length(), &error);
+        napi_reject_deferred(env, asyncData->deferred, error);
+    } else {
+        napi_value result;
+        napi_create_array_with_length(env, asyncData->results.size(), &result);
+        for (size_t i = 0; i < asyncData->results.size(); i++) {
+            napi_set_element(env, result, i, createDumpResultObject(env, asyncData->results[i]));
+        }
+        napi_resolve_deferred(env, asyncData->deferred, result);
+    }
+
+    napi_delete_async_work(env, asyncData->work);
+    deleteBatchAsyncData(asyncData);
+}
+
+// 解析dump列表：[{filePath, hashInfos}]
+static bool parseDumpJobs(napi_env env, napi_value array, std::vector<DumpAnalysisJob> &jobs) {
+    uint32_t arrayLength = 0;
+    if (napi_get_array_length(env, array, &arrayLength) != napi_ok) {
+        napi_throw_error(env, nullptr, "解析dump列表失败");
+        return false;
+    }
+    jobs.resize(arrayLength);
+    for (uint32_t i = 0; i < arrayLength; i++) {
+        napi_value jobObj;
+        napi_value filePath;
+        napi_value hashInfos;
+        if (napi_get_element(env, array, i, &jobObj) != napi_ok ||
+            napi_get_named_property(env, jobObj, "filePath", &filePath) != napi_ok ||
+            !getStringValue(env, filePath, jobs[i].file)) {
+            napi_throw_error(env, nullptr, "解析dump文件路径失败");
+            return false;
+        }
+        if (napi_get_named_property(env, jobObj, "hashInfos", &hashInfos) != napi_ok ||
+            !parseHashInfoArray(env, hashInfos, jobs[i].targets)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 批量分析多个dump，在工作线程池中并行执行，同时分析的dump受内存预算限制
+static napi_value AnalyzeDumpBatch(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 1) {
+        napi_throw_error(env, nullptr, "需要参数: dump列表");
         return nullptr;
     }
 
-    // 创建并启动异步工作
-    return createAndStartAsyncWork(env, filePath, std::move(nodeInfos), heapAnalyzeHashExecute, "HeapAnalyzeHashAsync");
+    BatchAnalyzeAsyncData *asyncData = new BatchAnalyzeAsyncData();
+    asyncData->env = env;
+    if (!parseDumpJobs(env, args[0], asyncData->jobs)) {
+        deleteBatchAsyncData(asyncData);
+        return nullptr;
+    }
+    napi_value options = argc >= 2 ? args[1] : nullptr;
+    napi_valuetype optionsType = napi_undefined;
+    if (options != nullptr && napi_typeof(env, options, &optionsType) == napi_ok && optionsType == napi_object) {
+        napi_value value;
+        napi_valuetype valueType = napi_undefined;
+        if (napi_get_named_property(env, options, "memoryBudget", &value) == napi_ok &&
+            napi_typeof(env, value, &valueType) == napi_ok && valueType == napi_number) {
+            double budget = 0;
+            napi_get_value_double(env, value, &budget);
+            asyncData->options.memoryBudget = budget > 0 ? static_cast<size_t>(budget) : 0;
+        }
+        valueType = napi_undefined;
+        if (napi_get_named_property(env, options, "maxDepth", &value) == napi_ok &&
+            napi_typeof(env, value, &valueType) == napi_ok && valueType == napi_number) {
+            int32_t maxDepth = 0;
+            napi_get_value_int32(env, value, &maxDepth);
+            if (maxDepth > 0) {
+                asyncData->options.maxDepth = maxDepth;
+            }
+        }
+        asyncData->options.quickCheck = getBoolOption(env, options, "quickCheck");
+        asyncData->options.approximate = getBoolOption(env, options, "approximate");
+        getDoubleOption(env, options, "sampleRate", asyncData->options.sampleRate);
+    }
+    if (!setupAnalyzeOptions(env, options, "onDumpResult", callDumpResultJs, asyncData->progressFn,
+                             asyncData->dumpResultFn, asyncData->monitor)) {
+        deleteBatchAsyncData(asyncData);
+        return nullptr;
+    }
+    asyncData->statsCallback = createStatsCallbackRef(env, options);
+
+    napi_value promise;
+    if (napi_create_promise(env, &asyncData->deferred, &promise) != napi_ok) {
+        deleteBatchAsyncData(asyncData);
+        return nullptr;
+    }
+
+    napi_value resourceName;
+    napi_create_string_utf8(env, "AnalyzeDumpBatchAsync", NAPI_AUTO_LENGTH, &resourceName);
+    if (napi_create_async_work(env, nullptr, resourceName, AnalyzeDumpBatchExecute, AnalyzeDumpBatchComplete,
+                               asyncData, &asyncData->work) != napi_ok) {
+        napi_reject_deferred(env, asyncData->deferred, nullptr);
+        deleteBatchAsyncData(asyncData);
+        return nullptr;
+    }
+    if (napi_queue_async_work(env, asyncData->work) != napi_ok) {
+        napi_delete_async_work(env, asyncData->work);
+        napi_reject_deferred(env, asyncData->deferred, nullptr);
+        deleteBatchAsyncData(asyncData);
+        return nullptr;
+    }
+    return promise;
+}
+
+// 异步统计rawheap中各JSType和构造函数名的对象数与大小，只读对象表和字符串表，不构建边也不生成快照；
+// options.sampleRate小于1时抽样估算并给出误差，options.hashInfos中的对象总是精确统计并在targets中列出
+static napi_value RawHeapSummary(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr, nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 1) {
+        napi_throw_error(env, nullptr, "需要一个参数: 文件路径");
+        return nullptr;
+    }
+
+    std::string filePath;
+    if (!getStringValue(env, args[0], filePath)) {
+        return nullptr;
+    }
+    std::shared_ptr<rawheap_translate::SummaryOptions> summaryOptions =
+        std::make_shared<rawheap_translate::SummaryOptions>();
+    napi_value options = argc >= 2 ? args[1] : nullptr;
+    getDoubleOption(env, options, "sampleRate", summaryOptions->sampleRate);
+    napi_valuetype optionsType = napi_undefined;
+    napi_value hashInfos;
+    napi_valuetype hashInfosType = napi_undefined;
+    if (options != nullptr && napi_typeof(env, options, &optionsType) == napi_ok && optionsType == napi_object &&
+        napi_get_named_property(env, options, "hashInfos", &hashInfos) == napi_ok &&
+        napi_typeof(env, hashInfos, &hashInfosType) == napi_ok && hashInfosType == napi_object) {
+        std::vector<std::pair<std::string, int>> nodeInfos;
+        if (!parseHashInfoArray(env, hashInfos, nodeInfos)) {
+            return nullptr;
+        }
+        for (const auto &nodeInfo : nodeInfos) {
+            summaryOptions->hashes.insert(static_cast<uint32_t>(nodeInfo.second));
+        }
+    }
+
+    std::shared_ptr<rawheap_translate::HeapSummary> summary = std::make_shared<rawheap_translate::HeapSummary>();
+    return queuePromiseWork(env, "RawHeapSummary",
+        [filePath, summaryOptions, summary](std::string &error, StatsSnapshot &stats) {
+            AnalysisMonitor monitor;
+            if (!rawheap_translate::RawHeap::SummarizeRawheap(filePath, *summary, &monitor, *summaryOptions)) {
+                error = "统计rawheap失败";
+            }
+            stats = monitor.getStats().snapshot("rawHeapSummary");
+        },
+        [summary](napi_env env) {
+            return createHeapSummaryObject(env, *summary);
+        }, options);
 }
 
+static napi_value createHeapDiffEntryObject(napi_env env, const HeapDiffEntry &entry) {
+    napi_value result;
+    napi_create_object(env, &result);
+    setStringProperty(env, result, "name", entry.name);
+    setDoubleProperty(env, result, "beforeCount", entry.beforeCount);
+    setDoubleProperty(env, result, "beforeSize", entry.beforeSize);
+    setDoubleProperty(env, result, "afterCount", entry.afterCount);
+    setDoubleProperty(env, result, "afterSize", entry.afterSize);
+    setDoubleProperty(env, result, "addedCount", entry.addedCount);
+    setDoubleProperty(env, result, "addedSize", entry.addedSize);
+    setDoubleProperty(env, result, "freedCount", entry.freedCount);
+    setDoubleProperty(env, result, "freedSize", entry.freedSize);
+    setDoubleProperty(env, result, "survivingCount", entry.survivingCount);
+    setDoubleProperty(env, result, "survivingSize", entry.survivingSize);
+    napi_value delta;
+    napi_create_int64(env, entry.countDelta(), &delta);
+    napi_set_named_property(env, result, "countDelta", delta);
+    napi_create_int64(env, entry.sizeDelta(), &delta);
+    napi_set_named_property(env, result, "sizeDelta", delta);
+    return result;
+}
+
+static napi_value createHeapDiffObject(napi_env env, const HeapDiffResult &diff) {
+    napi_value result;
+    napi_create_object(env, &result);
+    setStringProperty(env, result, "before", diff.before);
+    setStringProperty(env, result, "after", diff.after);
+    napi_set_named_property(env, result, "total", createHeapDiffEntryObject(env, diff.total));
+    napi_value classes;
+    napi_create_array_with_length(env, diff.classes.size(), &classes);
+    for (size_t i = 0; i < diff.classes.size(); i++) {
+        napi_set_element(env, classes, i, createHeapDiffEntryObject(env, diff.classes[i]));
+    }
+    napi_set_named_property(env, result, "classes", classes);
+    return result;
+}
+
+// 异步比较同一进程先后的两个dump(.rawheap或.heapsnapshot)，按对象id区分新增、释放和存活的对象并按构造函数名分组；
+// options.useIndex对应.heapsnapshot的sidecar索引，options.cancelToken用于取消
+static napi_value DiffDumps(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr, nullptr, nullptr};
+    if (napi_get_cb_info(env, info, &argc, args, nullptr, nullptr) != napi_ok) {
+        return nullptr;
+    }
+    if (argc < 2) {
+        napi_throw_error(env, nullptr, "需要两个参数: 先后两个dump的文件路径");
+        return nullptr;
+    }
+
+    std::string before;
+    std::string after;
+    if (!getStringValue(env, args[0], before) || !getStringValue(env, args[1], after)) {
+        return nullptr;
+    }
+    napi_value options = argc >= 3 ? args[2] : nullptr;
+    HeapDiffOptions diffOptions;
+    diffOptions.useIndex = getBoolOption(env, options, "useIndex");
+    CancelFlag cancelFlag;
+    napi_valuetype optionsType = napi_undefined;
+    napi_value token;
+    if (options != nullptr && napi_typeof(env, options, &optionsType) == napi_ok && optionsType == napi_object &&
+        napi_get_named_property(env, options, "cancelToken", &token) == napi_ok) {
+        cancelFlag = getCancelFlag(env, token);
+    }
+
+    std::shared_ptr<HeapDiffResult> diff = std::make_shared<HeapDiffResult>();
+    return queuePromiseWork(env, "DiffDumps",
+        [before, after, diffOptions, cancelFlag, diff](std::string &error, StatsSnapshot &stats) {
+            AnalysisMonitor monitor(cancelFlag);
+            *diff = diffDumps(before, after, diffOptions, &monitor);
+            error = diff->error;
+            stats = monitor.getStats().snapshot("diffDumps");
+        },
+        [diff](napi_env env) {
+            return createHeapDiffObject(env, *diff);
+        }, options);
+}
 
 EXTERN_C_START
 static napi_value Init(napi_env env, napi_value exports) {
     // 定义导出的方法
     napi_property_descriptor desc[] = {
         {"createTask", nullptr, CreateTask, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"createTaskAsync", nullptr, CreateTaskAsync, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"destroyTask", nullptr, DestroyTask, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"setSnapshotCacheBudget", nullptr, SetSnapshotCacheBudget, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"configureWorkerPool", nullptr, ConfigureWorkerPool, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getLastStats", nullptr, GetLastStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"setStatsDumpPath", nullptr, SetStatsDumpPath, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"getShortestPathToGCRoot", nullptr, GetShortestPathToGCRoot, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getShortestPathToGCRootAsync", nullptr, GetShortestPathToGCRootAsync, nullptr, nullptr, nullptr, napi_default,
+         nullptr},
+        {"getShortestPathToGCRootPacked", nullptr, GetShortestPathToGCRootPacked, nullptr, nullptr, nullptr,
+         napi_default, nullptr},
+        {"getRetainedInfo", nullptr, GetRetainedInfo, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"rawHeapTranslate", nullptr, rawHeapTranslate, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"rawHeapTranslateAsync", nullptr, RawHeapTranslateAsync, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"rawHeapSummary", nullptr, RawHeapSummary, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"rawAnalyzeHash", nullptr, RawAnalyzeHash, nullptr, nullptr, nullptr, napi_default, nullptr},
-        {"heapAnalyzeHash", nullptr, HeapAnalyzeHash, nullptr, nullptr, nullptr, napi_default, nullptr}};
+        {"heapAnalyzeHash", nullptr, HeapAnalyzeHash, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"rawAnalyzeHashPacked", nullptr, RawAnalyzeHashPacked, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"heapAnalyzeHashPacked", nullptr, HeapAnalyzeHashPacked, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"analyzeDumpBatch", nullptr, AnalyzeDumpBatch, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"diffDumps", nullptr, DiffDumps, nullptr, nullptr, nullptr, napi_default, nullptr}};
     napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
+
+    // 导出CancelToken类
+    napi_property_descriptor tokenDesc[] = {
+        {"cancel", nullptr, CancelTokenCancel, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"isCancelled", nullptr, CancelTokenIsCancelled, nullptr, nullptr, nullptr, napi_default, nullptr}};
+    napi_value cancelTokenClass;
+    if (napi_define_class(env, "CancelToken", NAPI_AUTO_LENGTH, CancelTokenConstructor, nullptr,
+                          sizeof(tokenDesc) / sizeof(tokenDesc[0]), tokenDesc, &cancelTokenClass) == napi_ok) {
+        napi_set_named_property(env, exports, "CancelToken", cancelTokenClass);
+    }
     return exports;
 }
 EXTERN_C_END
@@ -0,0 +1,102 @@
+#include <cstring>
+#include "packed_result.h"
+
+static size_t alignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+uint32_t PackedResultWriter::internString(const std::string& str) {
+    auto it = stringIds.find(str);
+    if (it != stringIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.push_back(str);
+    stringIds.emplace(str, id);
+    return id;
+}
+
+uint32_t PackedResultWriter::internNode(const ReferenceChainNode& node) {
+    auto it = nodeIds.find(node.id);
+    if (it != nodeIds.end()) {
+        return it->second;
+    }
+    PackedNode packed;
+    packed.id = node.id;
+    packed.name = internString(node.name);
+    packed.type = internString(node.type);
+    packed.path = internString(node.path);
+    packed.line = node.line;
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(packed);
+    nodeIds.emplace(node.id, index);
+    return index;
+}
+
+void PackedResultWriter::addTarget(int hash, const std::string& name, uint64_t selfSize, uint64_t retainedSize,
+                                   const std::vector<ReferenceChain>& chains) {
+    PackedTarget target;
+    target.hash = hash;
+    target.name = internString(name);
+    target.firstLink = static_cast<uint32_t>(links.size());
+    target.linkCount = static_cast<uint32_t>(chains.size());
+    target.selfSize = static_cast<double>(selfSize);
+    target.retainedSize = static_cast<double>(retainedSize);
+    targets.push_back(target);
+    for (const ReferenceChain& chain : chains) {
+        PackedLink link;
+        link.from = internNode(chain.referrer);
+        link.to = internNode(chain.current_node);
+        link.edgeType = internString(chain.edge_type);
+        links.push_back(link);
+    }
+}
+
+std::vector<uint8_t> PackedResultWriter::finish() const {
+    // ArkTS侧按固定的记录大小解码
+    static_assert(sizeof(PackedNode) == 24, "PackedNode layout changed");
+    static_assert(sizeof(PackedTarget) == 32, "PackedTarget layout changed");
+    static_assert(sizeof(PackedLink) == 12, "PackedLink layout changed");
+    const size_t headerSize = 12 * sizeof(uint32_t);
+    size_t stringOffsetsOffset = alignUp(headerSize);
+    size_t nodesOffset = alignUp(stringOffsetsOffset + (strings.size() + 1) * sizeof(uint32_t));
+    size_t targetsOffset = alignUp(nodesOffset + nodes.size() * sizeof(PackedNode));
+    size_t linksOffset = alignUp(targetsOffset + targets.size() * sizeof(PackedTarget));
+    size_t stringDataOffset = alignUp(linksOffset + links.size() * sizeof(PackedLink));
+    size_t stringDataLength = 0;
+    for (const std::string& str : strings) {
+        stringDataLength += str.size();
+    }
+    size_t totalLength = stringDataOffset + stringDataLength;
+
+    std::vector<uint8_t> buffer(totalLength, 0);
+    uint32_t header[12] = {
+        MAGIC, VERSION, static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(nodes.size()),
+        static_cast<uint32_t>(targets.size()), static_cast<uint32_t>(links.size()),
+        static_cast<uint32_t>(stringOffsetsOffset), static_cast<uint32_t>(nodesOffset),
+        static_cast<uint32_t>(targetsOffset), static_cast<uint32_t>(linksOffset),
+        static_cast<uint32_t>(stringDataOffset), static_cast<uint32_t>(totalLength)
+    };
+    memcpy(buffer.data(), header, sizeof(header));
+
+    uint32_t* stringOffsets = reinterpret_cast<uint32_t*>(buffer.data() + stringOffsetsOffset);
+    uint8_t* stringData = buffer.data() + stringDataOffset;
+    uint32_t offset = 0;
+    for (size_t i = 0; i < strings.size(); i++) {
+        stringOffsets[i] = offset;
+        memcpy(stringData + offset, strings[i].data(), strings[i].size());
+        offset += static_cast<uint32_t>(strings[i].size());
+    }
+    stringOffsets[strings.size()] = offset;
+
+    if (!nodes.empty()) {
+        memcpy(buffer.data() + nodesOffset, nodes.data(), nodes.size() * sizeof(PackedNode));
+    }
+    if (!targets.empty()) {
+        memcpy(buffer.data() + targetsOffset, targets.data(), targets.size() * sizeof(PackedTarget));
+    }
+    if (!links.empty()) {
+        memcpy(buffer.data() + linksOffset, links.data(), links.size() * sizeof(PackedLink));
+    }
+    return buffer;
+}
@@ -0,0 +1,62 @@
+#ifndef PACKED_RESULT_H
+#define PACKED_RESULT_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "heap_snapshot_parser.h"
+
+// 引用链结果的紧凑二进制编码，一次性以ArrayBuffer传给ArkTS，由ArkTS侧按需解码
+// 布局（本机字节序，各段按8字节对齐，偏移量均从缓冲区开头计算）：
+//   头部     12个uint32：magic, version, stringCount, nodeCount, targetCount, linkCount,
+//            stringOffsetsOffset, nodesOffset, targetsOffset, linksOffset, stringDataOffset, totalLength
+//   字符串   (stringCount + 1)个uint32偏移 + UTF-8数据，相同字符串只存一份
+//   节点     PackedNode[nodeCount]，相同id的引用链节点只存一份
+//   目标     PackedTarget[targetCount]，每个目标的引用链为links[firstLink, firstLink + linkCount)
+//   边       PackedLink[linkCount]
+class PackedResultWriter {
+public:
+    static constexpr uint32_t MAGIC = 0x5250474C;  // "LGPR"
+    static constexpr uint32_t VERSION = 1;
+
+    void addTarget(int hash, const std::string& name, uint64_t selfSize, uint64_t retainedSize,
+                   const std::vector<ReferenceChain>& chains);
+    std::vector<uint8_t> finish() const;
+
+private:
+    struct PackedNode {
+        uint64_t id;
+        uint32_t name;
+        uint32_t type;
+        uint32_t path;
+        int32_t line;
+    };
+
+    struct PackedTarget {
+        int32_t hash;
+        uint32_t name;
+        uint32_t firstLink;
+        uint32_t linkCount;
+        double selfSize;
+        double retainedSize;
+    };
+
+    struct PackedLink {
+        uint32_t from;
+        uint32_t to;
+        uint32_t edgeType;
+    };
+
+    uint32_t internString(const std::string& str);
+    uint32_t internNode(const ReferenceChainNode& node);
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIds;
+    std::vector<PackedNode> nodes;
+    std::unordered_map<uint64_t, uint32_t> nodeIds;
+    std::vector<PackedTarget> targets;
+    std::vector<PackedLink> links;
+};
+
+#endif // PACKED_RESULT_H
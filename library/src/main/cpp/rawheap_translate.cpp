@@ -13,7 +13,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include "rawheap_translate.h"
 #include "serializer.h"
 #include "rapidjson/document.h"
@@ -21,20 +24,13 @@
 namespace rawheap_translate {
 RawHeap::~RawHeap()
 {
-    for (auto node : nodes_) {
-        delete node;
-    }
-
-    for (auto edge : edges_) {
-        delete edge;
-    }
-
     delete strTable_;
     nodes_.clear();
     edges_.clear();
 }
 
-bool RawHeap::TranslateRawheap(const std::string &inputPath, const std::string &outputPath)
+bool RawHeap::TranslateRawheap(const std::string &inputPath, const std::string &outputPath, AnalysisMonitor *monitor,
+                               bool hashNodes)
 {
     auto start = std::chrono::steady_clock::now();
     FileReader file;
@@ -48,6 +44,7 @@ bool RawHeap::TranslateRawheap(const std::string &inputPath, const std::string &
         return false;
     }
 
+    ScopedPhase metaPhase(monitor, "metadata_parse");
     MetaParser metaParser;
     if (!ParseMetaData(file, &metaParser)) {
         return false;
@@ -57,8 +54,18 @@ bool RawHeap::TranslateRawheap(const std::string &inputPath, const std::string &
     if (rawheap == nullptr) {
         return false;
     }
+    metaPhase.end();
 
-    if (!rawheap->Parse(file, file.GetHeaderLeft()) || !rawheap->Translate()) {
+    rawheap->SetMonitor(monitor);
+    rawheap->SetHashNodes(hashNodes);
+    ScopedPhase readPhase(monitor, "section_read");
+    if (!rawheap->Parse(file, file.GetHeaderLeft())) {
+        delete rawheap;
+        return false;
+    }
+    readPhase.addCounts(rawheap->GetNodes()->size(), fileSize);
+    readPhase.end();
+    if (!rawheap->ReportProgress("read", fileSize, fileSize) || !rawheap->Translate()) {
         delete rawheap;
         return false;
     }
@@ -69,11 +76,95 @@ bool RawHeap::TranslateRawheap(const std::string &inputPath, const std::string &
         return false;
     }
 
-    HeapSnapshotJSONSerializer::Serialize(rawheap, &writer);
+    ScopedPhase serializePhase(monitor, "serialize");
+    bool serialized = HeapSnapshotJSONSerializer::Serialize(rawheap, &writer);
+    size_t itemCount = rawheap->GetNodes()->size() + rawheap->GetEdges()->size();
     delete rawheap;
+    if (!serialized) {
+        LOG_INFO_ << "serialize canceled!";
+        return false;
+    }
+    writer.EndOfStream();
+    serializePhase.addCounts(itemCount, FileReader::GetFileSize(outputPath));
+    serializePhase.end();
     auto end = std::chrono::steady_clock::now();
-    int duration = (int)std::chrono::duration<double>(end - start).count();
-    LOG_INFO_ << "file save to " << outputPath << ", cost " << std::to_string(duration) << 's';
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    LOG_INFO_ << "file save to " << outputPath << ", cost " << std::to_string(duration) << "ms";
+    return true;
+}
+
+std::unique_ptr<RawHeap> RawHeap::ParseTables(FileReader &file, MetaParser &metaParser, const std::string &inputPath,
+                                              AnalysisMonitor *monitor, const SummaryOptions *readFilter)
+{
+    if (!file.Initialize(inputPath)) {
+        return nullptr;
+    }
+
+    uint64_t fileSize = FileReader::GetFileSize(inputPath);
+    if (!file.CheckAndGetHeaderAt(fileSize - sizeof(uint64_t), 0)) {
+        LOG_ERROR_ << "Read rawheap file header failed!";
+        return nullptr;
+    }
+
+    ScopedPhase metaPhase(monitor, "metadata_parse");
+    if (!ParseMetaData(file, &metaParser)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<RawHeap> rawheap(ParseRawheap(file, &metaParser));
+    if (rawheap == nullptr) {
+        return nullptr;
+    }
+    metaPhase.end();
+
+    rawheap->SetMonitor(monitor);
+    rawheap->SetReadFilter(readFilter);
+    ScopedPhase readPhase(monitor, "section_read");
+    if (!rawheap->Parse(file, file.GetHeaderLeft())) {
+        return nullptr;
+    }
+    readPhase.addCounts(rawheap->GetNodes()->size(), fileSize);
+    readPhase.end();
+    if (!rawheap->ReportProgress("read", fileSize, fileSize)) {
+        return nullptr;
+    }
+    return rawheap;
+}
+
+bool RawHeap::SummarizeRawheap(const std::string &inputPath, HeapSummary &summary, AnalysisMonitor *monitor,
+                               const SummaryOptions &options)
+{
+    FileReader file;
+    MetaParser metaParser;
+    std::unique_ptr<RawHeap> rawheap = ParseTables(file, metaParser, inputPath, monitor, &options);
+    if (rawheap == nullptr) {
+        return false;
+    }
+
+    ScopedPhase summaryPhase(monitor, "summary");
+    if (!rawheap->ResolveTypes(options)) {
+        return false;
+    }
+    rawheap->FillSummary(&metaParser, options, summary);
+    summaryPhase.addCounts(summary.sampledCount, 0);
+    return true;
+}
+
+bool RawHeap::CollectRawheapObjects(const std::string &inputPath, HeapObjects &objects, AnalysisMonitor *monitor)
+{
+    FileReader file;
+    MetaParser metaParser;
+    std::unique_ptr<RawHeap> rawheap = ParseTables(file, metaParser, inputPath, monitor);
+    if (rawheap == nullptr) {
+        return false;
+    }
+
+    ScopedPhase objectPhase(monitor, "objects");
+    if (!rawheap->ResolveTypes(SummaryOptions())) {
+        return false;
+    }
+    rawheap->FillObjects(&metaParser, objects);
+    objectPhase.addCounts(objects.objects.size(), 0);
     return true;
 }
 
@@ -136,12 +227,12 @@ std::string RawHeap::ReadVersion(FileReader &file)
     return std::string(version.data());
 }
 
-std::vector<Node *>* RawHeap::GetNodes()
+std::vector<Node>* RawHeap::GetNodes()
 {
     return &nodes_;
 }
 
-std::vector<Edge *>* RawHeap::GetEdges()
+std::vector<Edge>* RawHeap::GetEdges()
 {
     return &edges_;
 }
@@ -166,17 +257,96 @@ std::string RawHeap::GetVersion()
     return version_;
 }
 
+void RawHeap::SetMonitor(AnalysisMonitor *monitor)
+{
+    monitor_ = monitor;
+}
+
+AnalysisMonitor *RawHeap::GetMonitor()
+{
+    return monitor_;
+}
+
+bool RawHeap::ReportProgress(const char *phase, uint64_t bytes, uint64_t totalBytes)
+{
+    if (monitor_ == nullptr) {
+        return true;
+    }
+    return monitor_->report(phase, bytes, totalBytes, nodes_.size(), edges_.size());
+}
+
+void RawHeap::SetHashNodes(bool hashNodes)
+{
+    hashNodes_ = hashNodes;
+}
+
+void RawHeap::SetReadFilter(const SummaryOptions *options)
+{
+    readFilter_ = options;
+}
+
+bool RawHeap::IsRead(uint64_t nodeId)
+{
+    return readFilter_ == nullptr || IsSummarized(nodeId, *readFilter_);
+}
+
+bool RawHeap::HasHashNodes()
+{
+    return hashNodes_;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>>* RawHeap::GetHashIndex()
+{
+    return &hashIndex_;
+}
+
 Node *RawHeap::CreateNode()
 {
-    Node *node = new Node(nodeIndex_++);
-    nodes_.push_back(node);
-    return node;
+    nodes_.emplace_back(nodeIndex_++);
+    return &nodes_.back();
+}
+
+Node *RawHeap::GetNode(uint32_t index)
+{
+    return &nodes_[index];
+}
+
+void RawHeap::ReserveNodes(size_t count)
+{
+    nodes_.reserve(count);
+}
+
+void RawHeap::ReserveStrings(size_t count)
+{
+    strTable_->Reserve(strTable_->GetCapcity() + count);
+}
+
+// Counting pre-pass before the edges are built: every 8-byte slot of an object (the first one is the hclass)
+// may become an edge, plus one hash edge. Reserving this upper bound once replaces the repeated growth of
+// edges_; the part never written is not touched and costs address space only.
+void RawHeap::ReserveForTranslate()
+{
+    size_t edgeCount = edges_.size();
+    size_t hashCount = 0;
+    for (const Node &node : nodes_) {
+        edgeCount += node.size / sizeof(uint64_t) + 1;
+        if ((node.nodeId >> 32) != 0) {  // 32: the high-32bits means hash value
+            hashCount++;
+        }
+    }
+    edges_.reserve(edgeCount);
+    if (hashNodes_) {
+        nodes_.reserve(nodes_.size() + hashCount);
+        primitiveNodes_.reserve(hashCount);
+        ReserveStrings(hashCount);
+    } else {
+        hashIndex_.reserve(hashCount);
+    }
 }
 
 void RawHeap::InsertEdge(Node *toNode, uint32_t indexOrStrId, EdgeType type)
 {
-    Edge *edge = new Edge(toNode, indexOrStrId, type);
-    edges_.push_back(edge);
+    edges_.emplace_back(toNode->index, indexOrStrId, type);
 }
 
 StringId RawHeap::InsertAndGetStringId(const std::string &str)
@@ -191,29 +361,253 @@ void RawHeap::SetVersion(const std::string &version)
 
 void RawHeap::CreateHashEdge(Node *node)
 {
-    static const StringId hashStrId = InsertAndGetStringId("ArkInternalHash");
     uint32_t hash = static_cast<uint32_t>(node->nodeId >> 32);  // 32: the high-32bits means hash value
     node->nodeId &= 0xFFFFFFFFULL;
     if (hash == 0) {
         return;
     }
-
-    Node *hashNode = new Node(nodeIndex_++);
-    hashNode->nodeId = 0;
-    hashNode->type = 7;  // 7: means HEAPNUMBER
-    hashNode->strId = InsertAndGetStringId("Int:" + std::to_string(hash));
-    InsertEdge(hashNode, hashStrId, EdgeType::DEFAULT);
-    primitiveNodes_.push_back(hashNode);
-    node->edgeCount++;
-
 #ifdef OHOS_UNIT_TEST
     hashSet_.insert(hash);
 #endif
+    if (!hashNodes_) {
+        // node indexes equal the positions in nodes_, hash nodes would only be appended after them
+        hashIndex_.emplace_back(hash, node->index);
+        return;
+    }
+    if (hashStrId_ == 0) {
+        hashStrId_ = InsertAndGetStringId("ArkInternalHash");
+    }
+
+    primitiveNodes_.emplace_back(nodeIndex_++);
+    Node &hashNode = primitiveNodes_.back();
+    hashNode.nodeId = 0;
+    hashNode.type = 7;  // 7: means HEAPNUMBER
+    hashNode.strId = InsertAndGetStringId("Int:" + std::to_string(hash));
+    InsertEdge(&hashNode, hashStrId_, EdgeType::DEFAULT);
+    node->edgeCount++;
 }
 
 void RawHeap::AddPrimitiveNodes()
 {
     nodes_.insert(nodes_.end(), primitiveNodes_.begin(), primitiveNodes_.end());
+    std::vector<Node>().swap(primitiveNodes_);
+}
+
+namespace {
+// sums of one summary group: objects counted with certainty plus the sampled ones, which are scaled up by
+// the Horvitz-Thompson estimator with the variance (1 - rate) / rate^2 * sum(x^2)
+struct SummaryAccumulator {
+    uint64_t exactCount = 0;
+    uint64_t exactSelf = 0;
+    uint64_t exactNative = 0;
+    uint64_t sampleCount = 0;
+    double sampleSelf = 0;
+    double sampleNative = 0;
+    double sampleSelfSquares = 0;
+    double sampleNativeSquares = 0;
+
+    void Add(const Node &node, bool exact)
+    {
+        if (exact) {
+            exactCount++;
+            exactSelf += node.size;
+            exactNative += node.nativeSize;
+            return;
+        }
+        double self = node.size;
+        double native = node.nativeSize;
+        sampleCount++;
+        sampleSelf += self;
+        sampleNative += native;
+        sampleSelfSquares += self * self;
+        sampleNativeSquares += native * native;
+    }
+
+    bool Empty() const
+    {
+        return exactCount == 0 && sampleCount == 0;
+    }
+
+    void Finish(double rate, SummaryEntry &entry) const
+    {
+        constexpr double Z_95 = 1.96;  // two-sided 95% normal quantile
+        auto estimate = [rate](uint64_t exact, double sample) {
+            return exact + static_cast<uint64_t>(std::llround(sample / rate));
+        };
+        auto error = [rate](double squares) {
+            return static_cast<uint64_t>(std::ceil(Z_95 * std::sqrt((1 - rate) / (rate * rate) * squares)));
+        };
+        entry.count = estimate(exactCount, static_cast<double>(sampleCount));
+        entry.selfSize = estimate(exactSelf, sampleSelf);
+        entry.nativeSize = estimate(exactNative, sampleNative);
+        entry.countError = error(static_cast<double>(sampleCount));
+        entry.selfSizeError = error(sampleSelfSquares);
+        entry.nativeSizeError = error(sampleNativeSquares);
+    }
+};
+
+// a rate outside (0, 1) counts every object
+double SampleRate(const SummaryOptions &options)
+{
+    return options.sampleRate > 0 && options.sampleRate < 1 ? options.sampleRate : 1.0;
+}
+
+uint64_t SampleThreshold(double rate)
+{
+    constexpr double SAMPLE_RANGE = 4294967296.0;  // 2^32, sample keys are 32 bits
+    return static_cast<uint64_t>(rate * SAMPLE_RANGE);
+}
+
+// splitmix64 finalizer of the object id, ids are sequential so they must be mixed before sampling
+uint64_t SampleKey(uint64_t nodeId)
+{
+    uint64_t key = (nodeId & 0xFFFFFFFFULL) + 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return (key ^ (key >> 31)) >> 32;  // 32: keep the high half as the sample key
+}
+
+bool IsTarget(uint64_t nodeId, const SummaryOptions &options)
+{
+    uint32_t hash = static_cast<uint32_t>(nodeId >> 32);  // 32: the high-32bits means hash value
+    return hash != 0 && options.hashes.count(hash) != 0;
+}
+}
+
+bool RawHeap::IsSummarized(uint64_t nodeId, const SummaryOptions &options)
+{
+    double rate = SampleRate(options);
+    return rate >= 1 || SampleKey(nodeId) < SampleThreshold(rate) || IsTarget(nodeId, options);
+}
+
+void RawHeap::FillSummary(MetaParser *metaParser, const SummaryOptions &options, HeapSummary &summary)
+{
+    double rate = SampleRate(options);
+    uint64_t threshold = SampleThreshold(rate);
+    std::vector<SummaryAccumulator> types(std::numeric_limits<JSType>::max() + 1);
+    std::unordered_map<StringId, SummaryAccumulator> names;
+    SummaryAccumulator total;
+    summary.targets.clear();
+    for (auto it = nodes_.begin() + 1; it != nodes_.end(); ++it) {
+        bool target = !options.hashes.empty() && IsTarget(it->nodeId, options);
+        bool exact = rate >= 1 || target;
+        if (!exact && SampleKey(it->nodeId) >= threshold) {
+            continue;
+        }
+        bool named = it->strId >= StringHashMap::CUSTOM_STRID_START && !metaParser->IsString(it->jsType);
+        total.Add(*it, exact);
+        types[it->jsType].Add(*it, exact);
+        if (named) {
+            names[it->strId].Add(*it, exact);
+        }
+        if (target) {
+            SummaryTarget item;
+            item.hash = static_cast<uint32_t>(it->nodeId >> 32);  // 32: the high-32bits means hash value
+            item.nodeId = it->nodeId & 0xFFFFFFFFULL;
+            item.type = metaParser->GetTypeName(it->jsType);
+            item.name = named ? strTable_->GetStringByKey(strTable_->GetKeyByStringId(it->strId)) : "";
+            item.selfSize = it->size;
+            item.nativeSize = it->nativeSize;
+            summary.targets.push_back(std::move(item));
+        }
+    }
+
+    SummaryEntry totalEntry;
+    total.Finish(rate, totalEntry);
+    summary.sampleRate = rate;
+    summary.sampledCount = total.exactCount + total.sampleCount;
+    summary.objectCount = totalEntry.count;
+    summary.selfSize = totalEntry.selfSize;
+    summary.nativeSize = totalEntry.nativeSize;
+    summary.objectCountError = totalEntry.countError;
+    summary.selfSizeError = totalEntry.selfSizeError;
+    summary.nativeSizeError = totalEntry.nativeSizeError;
+    summary.types.clear();
+    for (size_t type = 0; type < types.size(); ++type) {
+        if (!types[type].Empty()) {
+            SummaryEntry entry;
+            types[type].Finish(rate, entry);
+            entry.name = metaParser->GetTypeName(static_cast<JSType>(type));
+            summary.types.push_back(std::move(entry));
+        }
+    }
+    summary.names.clear();
+    summary.names.reserve(names.size());
+    for (auto &name : names) {
+        SummaryEntry entry;
+        name.second.Finish(rate, entry);
+        entry.name = strTable_->GetStringByKey(strTable_->GetKeyByStringId(name.first));
+        summary.names.push_back(std::move(entry));
+    }
+
+    auto bySize = [](const SummaryEntry &a, const SummaryEntry &b) {
+        return a.selfSize != b.selfSize ? a.selfSize > b.selfSize : a.name < b.name;
+    };
+    std::sort(summary.types.begin(), summary.types.end(), bySize);
+    std::sort(summary.names.begin(), summary.names.end(), bySize);
+}
+
+std::string HeapObjects::ClassName(NodeType type, const std::string &name)
+{
+    // node_types of the serialized snapshot
+    static const char *const NODE_TYPE_NAMES[] = {
+        "hidden", "array", "string", "object", "code", "closure", "regexp", "number", "native", "synthetic",
+        "concatenated string", "slicedstring", "symbol", "bigint", "framework"
+    };
+    constexpr NodeType HIDDEN_NODETYPE = 0;
+    constexpr NodeType OBJECT_NODETYPE = 3;
+    constexpr NodeType NATIVE_NODETYPE = 8;
+    if (type == OBJECT_NODETYPE || type == NATIVE_NODETYPE) {
+        return name;
+    }
+    if (type == HIDDEN_NODETYPE) {
+        return "(system)";
+    }
+    if (type >= sizeof(NODE_TYPE_NAMES) / sizeof(NODE_TYPE_NAMES[0])) {
+        return "(unknown)";
+    }
+    return std::string("(") + NODE_TYPE_NAMES[type] + ")";
+}
+
+void RawHeap::FillObjects(MetaParser *metaParser, HeapObjects &objects)
+{
+    // object and native nodes are grouped by their snapshot name: the string table name, or the lower-case type
+    // name that Translate gives unnamed objects; other nodes only by node type
+    constexpr NodeType OBJECT_NODETYPE = 3;
+    constexpr NodeType NATIVE_NODETYPE = 8;
+    constexpr uint64_t NAME_KEY = 1ULL << 40;     // 40: above any string id
+    constexpr uint64_t TYPE_NAME_KEY = 2ULL << 40;
+    constexpr uint64_t NODE_TYPE_KEY = 3ULL << 40;
+    std::unordered_map<uint64_t, uint32_t> classes;
+    objects.classNames.clear();
+    objects.objects.clear();
+    objects.objects.reserve(nodes_.size() - 1);
+    for (auto it = nodes_.begin() + 1; it != nodes_.end(); ++it) {
+        bool byName = it->type == OBJECT_NODETYPE || it->type == NATIVE_NODETYPE;
+        bool named = it->strId >= StringHashMap::CUSTOM_STRID_START;
+        uint64_t key = !byName ? NODE_TYPE_KEY | it->type : (named ? NAME_KEY | it->strId : TYPE_NAME_KEY | it->jsType);
+        auto inserted = classes.emplace(key, static_cast<uint32_t>(objects.classNames.size()));
+        if (inserted.second) {
+            std::string name;
+            if (byName && named) {
+                name = strTable_->GetStringByKey(strTable_->GetKeyByStringId(it->strId));
+            } else if (byName && !metaParser->IsString(it->jsType)) {
+                name = metaParser->GetTypeName(it->jsType);
+                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            }
+            objects.classNames.push_back(HeapObjects::ClassName(it->type, name));
+        }
+        HeapObject object;
+        object.id = it->nodeId & 0xFFFFFFFFULL;  // 32: the high-32bits means hash value
+        object.size = static_cast<uint64_t>(it->size) + it->nativeSize;
+        object.classIndex = inserted.first->second;
+        objects.objects.push_back(object);
+    }
+    // table order usually follows the ids already
+    auto byId = [](const HeapObject &a, const HeapObject &b) { return a.id < b.id; };
+    if (!std::is_sorted(objects.objects.begin(), objects.objects.end(), byId)) {
+        std::sort(objects.objects.begin(), objects.objects.end(), byId);
+    }
 }
 
 bool RawHeap::ReadSectionInfo(FileReader &file, uint32_t offset, std::vector<uint32_t> &section)
@@ -233,6 +627,120 @@ bool RawHeap::ReadSectionInfo(FileReader &file, uint32_t offset, std::vector<uin
     return true;
 }
 
+bool RawHeap::ScanHashes(const std::string &inputPath, const std::unordered_set<uint32_t> &hashes,
+                         std::unordered_set<uint32_t> &found, AnalysisMonitor *monitor)
+{
+    ScopedPhase phase(monitor, "hash_scan");
+    FileReader file;
+    if (!file.Initialize(inputPath)) {
+        return false;
+    }
+
+    uint64_t fileSize = FileReader::GetFileSize(inputPath);
+    if (!file.CheckAndGetHeaderAt(fileSize - sizeof(uint64_t), 0)) {
+        LOG_ERROR_ << "Read rawheap file header failed!";
+        return false;
+    }
+    uint32_t metaOffset = file.GetHeaderLeft();
+
+    Version version;
+    std::vector<uint32_t> sections;
+    if (!version.Parse(ReadVersion(file)) || VERSION < version || !ReadSectionInfo(file, metaOffset, sections)) {
+        return false;
+    }
+
+    // V1 has one object table per region from section 4 with step 2, V2 has a single table at section 4
+    size_t step = Version(1, 0, 0) < version ? sections.size() : 2;
+    for (size_t i = 4; i < sections.size() && found.size() < hashes.size(); i += step) {
+        if (monitor != nullptr && monitor->isCancelled()) {
+            return false;
+        }
+        if (!ScanObjectTableHashes(file, sections[i], hashes, found)) {
+            return false;
+        }
+    }
+    phase.addCounts(found.size(), fileSize);
+    return true;
+}
+
+bool RawHeap::ScanObjectTableHashes(FileReader &file, uint32_t offset, const std::unordered_set<uint32_t> &hashes,
+                                    std::unordered_set<uint32_t> &found)
+{
+    // both AddrTableItem and AddrTableItemV2 keep the 64-bit node id at offset 8, the memory after the table is skipped
+    constexpr uint32_t ID_OFFSET = sizeof(uint64_t);
+    constexpr uint32_t BATCH_ITEMS = 4096;
+    if (!file.CheckAndGetHeaderAt(offset, 0) || file.GetHeaderRight() < ID_OFFSET + sizeof(uint64_t)) {
+        LOG_ERROR_ << "object table header error!";
+        return false;
+    }
+
+    uint32_t count = file.GetHeaderLeft();
+    uint32_t itemSize = file.GetHeaderRight();
+    std::vector<char> data(static_cast<size_t>(std::min(count, BATCH_ITEMS)) * itemSize);
+    for (uint32_t start = 0; start < count && found.size() < hashes.size(); start += BATCH_ITEMS) {
+        uint32_t items = std::min(count - start, BATCH_ITEMS);
+        if (!file.Read(data.data(), items * itemSize)) {
+            LOG_ERROR_ << "read object table failed!";
+            return false;
+        }
+        for (uint32_t i = 0; i < items; ++i) {
+            uint32_t hash = static_cast<uint32_t>(ByteToU64(data.data() + i * itemSize + ID_OFFSET) >> 32);
+            if (hash != 0 && hashes.count(hash) != 0) {
+                found.insert(hash);
+            }
+        }
+    }
+    return true;
+}
+
+void AddressIndex::Build(const std::vector<std::pair<uint64_t, uint32_t>> &entries)
+{
+    Clear();
+    if (entries.empty()) {
+        return;
+    }
+    keys_.resize(entries.size());
+    values_.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        keys_[i] = entries[i].first;
+        values_[i] = entries[i].second;
+    }
+
+    // shift the address range down to about as many buckets as addresses
+    base_ = keys_.front();
+    uint64_t range = keys_.back() - base_;
+    uint32_t rangeBits = range == 0 ? 0 : 64 - __builtin_clzll(range);  // 64: bits of an address
+    uint32_t countBits = 64 - __builtin_clzll(static_cast<uint64_t>(keys_.size()));
+    shift_ = rangeBits > countBits ? rangeBits - countBits : 0;
+    bucketCount_ = (range >> shift_) + 1;
+    buckets_.assign(bucketCount_ + 1, 0);
+    size_t i = 0;
+    for (uint64_t b = 0; b < bucketCount_; ++b) {
+        buckets_[b] = static_cast<uint32_t>(i);
+        while (i < keys_.size() && ((keys_[i] - base_) >> shift_) == b) {
+            ++i;
+        }
+    }
+    buckets_[bucketCount_] = static_cast<uint32_t>(keys_.size());
+}
+
+void AddressIndex::Remap(const std::vector<uint32_t> &values)
+{
+    for (auto &value : values_) {
+        value = value < values.size() ? values[value] : NOT_FOUND;
+    }
+}
+
+void AddressIndex::Clear()
+{
+    std::vector<uint64_t>().swap(keys_);
+    std::vector<uint32_t>().swap(values_);
+    buckets_.assign(1, 0);
+    base_ = 0;
+    bucketCount_ = 0;
+    shift_ = 0;
+}
+
 RawHeapTranslateV1::~RawHeapTranslateV1()
 {
     for (auto &mem : mem_) {
@@ -240,49 +748,129 @@ RawHeapTranslateV1::~RawHeapTranslateV1()
     }
     mem_.clear();
     sections_.clear();
-    nodesMap_.clear();
+    addrIndex_.Clear();
 }
 
 bool RawHeapTranslateV1::Parse(FileReader &file, uint32_t rawheapFileSize)
 {
-    if (!ReadSectionInfo(file, rawheapFileSize, sections_) || !ReadRootTable(file) || !ReadStringTable(file)) {
+    if (!ReadSectionInfo(file, rawheapFileSize, sections_)) {
         return false;
     }
 
-    // 4: object table section start from 4, step is 2
+    // counting pre-pass: the object table headers give the exact object count
+    size_t objectCount = 0;
+    for (size_t i = 4; i < sections_.size(); i += 2) {  // 4: object table section start from 4, step is 2
+        if (!file.CheckAndGetHeaderAt(sections_[i], 0)) {
+            LOG_ERROR_ << "object table header error!";
+            return false;
+        }
+        objectCount += file.GetHeaderLeft();
+    }
+    ReserveNodes(objectCount + 1);  // 1: the synthetic root
+    nodeData_.reserve(objectCount + 1);
+    objects_.reserve(objectCount);
+
+    // the address index needs every object up front, nodes are still created in the order the roots,
+    // the string table and then the object tables first refer to them
     for (size_t i = 4; i < sections_.size(); i += 2) {
         if (!ReadObjectTable(file, sections_[i], sections_[i + 1])) {
             return false;
         }
     }
+    BuildAddressIndex();
+    if (!ReadRootTable(file) || !ReadStringTable(file)) {
+        return false;
+    }
+    CreateObjectNodes();
     return true;
 }
 
 bool RawHeapTranslateV1::Translate()
 {
+    // V1的节点属性和边在同一个循环中生成，统一计入edge_build
+    ScopedPhase phase(GetMonitor(), "edge_build");
+    // slot visitors by VisitKind, the kind is resolved once per type and dispatched once per node
+    using BuildEdgesFunc = void (RawHeapTranslateV1::*)(Node *, const TypeVisit &);
+    static const BuildEdgesFunc BUILD_EDGES[static_cast<uint8_t>(VisitKind::COUNT)] = {
+        &RawHeapTranslateV1::BuildEdges<VisitKind::NONE>,
+        &RawHeapTranslateV1::BuildEdges<VisitKind::FIELDS>,
+        &RawHeapTranslateV1::BuildEdges<VisitKind::JS_OBJECT>,
+        &RawHeapTranslateV1::BuildEdges<VisitKind::ARRAY>,
+        &RawHeapTranslateV1::BuildEdges<VisitKind::GLOBAL_ENV>,
+    };
+    ReserveForTranslate();
+    typeVisits_.assign(std::numeric_limits<JSType>::max() + 1, TypeVisit {});
     auto nodes = GetNodes();
+    nodeData_.resize(nodes->size(), nullptr);
     for (auto it = nodes->begin() + 1; it != nodes->end(); ++it) {
-        Node *node = *it;
-        Node *hclass = FindNode(ByteToU64(node->data));
-        if (hclass == nullptr) {
+        if (((it - nodes->begin()) & PROGRESS_MASK) == 0 && !ReportProgress("translate")) {
+            LOG_INFO_ << "translate canceled!";
+            return false;
+        }
+        Node *node = &*it;
+        char *data = GetNodeData(node);
+        Node *hclass = data == nullptr ? nullptr : FindNode(ByteToU64(data));
+        if (hclass == nullptr || GetNodeData(hclass) == nullptr) {
             LOG_ERROR_ << "missed hclass, node_id=" << node->nodeId;
             return false;
         }
 
-        JSType type = metaParser_->GetJSTypeFromHClass(hclass);
+        JSType type = metaParser_->GetJSTypeFromHClass(GetNodeData(hclass));
         FillNodes(node, type);
         CreateHClassEdge(node, hclass);
         CreateHashEdge(node);
         if (!metaParser_->IsString(type)) {
-            BuildEdges(node, type);
+            const TypeVisit &visit = GetTypeVisit(type);
+            (this->*BUILD_EDGES[static_cast<uint8_t>(visit.kind)])(node, visit);
         }
     }
 
     AddPrimitiveNodes();
+    phase.addCounts(GetEdges()->size(), 0);
     LOG_INFO_ << "success!";
     return true;
 }
 
+bool RawHeapTranslateV1::ResolveTypes(const SummaryOptions &options)
+{
+    // V1 object tables carry no type, it is resolved through the hclass as in Translate for the counted objects
+    auto nodes = GetNodes();
+    nodeData_.resize(nodes->size(), nullptr);
+    std::unordered_map<StringId, bool> frameworkNames;
+    for (auto it = nodes->begin() + 1; it != nodes->end(); ++it) {
+        if (((it - nodes->begin()) & PROGRESS_MASK) == 0 && !ReportProgress("summary")) {
+            LOG_INFO_ << "summary canceled!";
+            return false;
+        }
+        Node *node = &*it;
+        if (!IsSummarized(node->nodeId, options)) {
+            continue;
+        }
+        char *data = GetNodeData(node);
+        Node *hclass = data == nullptr ? nullptr : FindNode(LoadU64(data));
+        if (hclass == nullptr || GetNodeData(hclass) == nullptr) {
+            LOG_ERROR_ << "missed hclass, node_id=" << node->nodeId;
+            return false;
+        }
+        node->jsType = metaParser_->GetJSTypeFromHClass(GetNodeData(hclass));
+        node->nativeSize = metaParser_->GetNativateSize(data, node->jsType);
+        node->type = metaParser_->GetNodeType(node->jsType);
+        if (node->strId >= StringHashMap::CUSTOM_STRID_START) {
+            // same rule as FillNodes, each name is checked once
+            auto framework = frameworkNames.find(node->strId);
+            if (framework == frameworkNames.end()) {
+                StringKey stringKey = GetStringTable()->GetKeyByStringId(node->strId);
+                bool isFramework = GetStringTable()->GetStringByKey(stringKey).find("_GLOBAL") != std::string::npos;
+                framework = frameworkNames.emplace(node->strId, isFramework).first;
+            }
+            if (framework->second) {
+                node->type = FRAMEWORK_NODETYPE;
+            }
+        }
+    }
+    return true;
+}
+
 bool RawHeapTranslateV1::ReadRootTable(FileReader &file)
 {
     if (!file.CheckAndGetHeaderAt(sections_[0], sizeof(uint64_t))) {
@@ -310,6 +898,7 @@ bool RawHeapTranslateV1::ReadStringTable(FileReader &file)
     }
 
     uint32_t strCnt = file.GetHeaderLeft();
+    ReserveStrings(strCnt);
     for (uint32_t i = 0; i < strCnt; ++i) {
         ParseStringTable(file);
     }
@@ -343,18 +932,13 @@ bool RawHeapTranslateV1::ReadObjectTable(FileReader &file, uint32_t offset, uint
             ByteToU32(data + sizeof(uint64_t) * 2),     // objSize
             ByteToU32(data + sizeof(uint64_t) * 2 + sizeof(uint32_t))   // offset
         };
-        uint64_t addr = table.addr;
-        Node *node = FindOrCreateNode(addr);
-        node->nodeId = table.id;
-        node->size = table.objSize;
-
         uint32_t memOffset = table.offset - tableSize;
         if (memOffset + sizeof(uint64_t) > memSize) {
             LOG_ERROR_ << "object memory offset error!";
             return false;
         }
 
-        node->data = mem + memOffset;
+        objects_.push_back({table.addr, table.id, table.objSize, mem + memOffset});
         data += file.GetHeaderRight();
     }
     LOG_INFO_ << "section objects count " << file.GetHeaderLeft();
@@ -392,48 +976,97 @@ void RawHeapTranslateV1::AddSyntheticRootNode(std::vector<uint64_t> &roots)
     syntheticRoot->nodeId = 1;      // 1: means root node
     syntheticRoot->type = 9;        // 9: means SYNTHETIC node type
     syntheticRoot->strId = InsertAndGetStringId("SyntheticRoot");
-    syntheticRoot->edgeCount = roots.size();
 
     StringId strId = InsertAndGetStringId("-subroot-");
     EdgeType type = EdgeType::SHORTCUT;
+    uint32_t edgeCount = 0;
     for (auto addr : roots) {
         Node *root = FindOrCreateNode(addr);
+        if (root == nullptr) {
+            continue;
+        }
         InsertEdge(root, strId, type);
+        edgeCount++;
     }
+    GetNode(0)->edgeCount = edgeCount;
 }
 
 void RawHeapTranslateV1::SetNodeStringId(const std::vector<uint64_t> &objects, StringId strId)
 {
     for (auto addr : objects) {
         Node *node = FindOrCreateNode(addr);
-        node->strId = strId;
+        if (node != nullptr) {
+            node->strId = strId;
+        }
     }
 }
 
+void RawHeapTranslateV1::BuildAddressIndex()
+{
+    std::vector<std::pair<uint64_t, uint32_t>> entries(objects_.size());
+    for (size_t i = 0; i < objects_.size(); ++i) {
+        entries[i] = {objects_[i].addr, static_cast<uint32_t>(i)};
+    }
+    std::sort(entries.begin(), entries.end());
+    // an address listed twice keeps its last item, the same item the object tables wrote last
+    size_t count = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (count > 0 && entries[count - 1].first == entries[i].first) {
+            entries[count - 1] = entries[i];
+        } else {
+            entries[count++] = entries[i];
+        }
+    }
+    entries.resize(count);
+    addrIndex_.Build(entries);
+    objectNodes_.assign(objects_.size(), AddressIndex::NOT_FOUND);
+}
+
+void RawHeapTranslateV1::CreateObjectNodes()
+{
+    for (const auto &item : objects_) {
+        FindOrCreateNode(item.addr);
+    }
+    // from now on the index resolves addresses to node indexes directly
+    addrIndex_.Remap(objectNodes_);
+    std::vector<ObjectItem>().swap(objects_);
+    std::vector<uint32_t>().swap(objectNodes_);
+}
+
+// only used while parsing: addresses missing from the object tables have no node
 Node *RawHeapTranslateV1::FindOrCreateNode(uint64_t addr)
 {
-    Node *node = FindNode(addr);
-    if (node != nullptr) {
-        return node;
+    uint32_t item = addrIndex_.Find(addr);
+    if (item == AddressIndex::NOT_FOUND) {
+        return nullptr;
     }
-    node = CreateNode();
-    nodesMap_.emplace(addr, node);
+    if (objectNodes_[item] != AddressIndex::NOT_FOUND) {
+        return GetNode(objectNodes_[item]);
+    }
+    Node *node = CreateNode();
+    node->nodeId = objects_[item].id;
+    node->size = objects_[item].size;
+    nodeData_.resize(node->index + 1, nullptr);
+    nodeData_[node->index] = objects_[item].data;
+    objectNodes_[item] = node->index;
     return node;
 }
 
 Node *RawHeapTranslateV1::FindNode(uint64_t addr)
 {
-    auto it = nodesMap_.find(addr);
-    if (it != nodesMap_.end()) {
-        return it->second;
-    }
-    return nullptr;
+    uint32_t index = addrIndex_.Find(addr);
+    return index == AddressIndex::NOT_FOUND ? nullptr : GetNode(index);
+}
+
+char *RawHeapTranslateV1::GetNodeData(Node *node)
+{
+    return node->index < nodeData_.size() ? nodeData_[node->index] : nullptr;
 }
 
 void RawHeapTranslateV1::FillNodes(Node *node, JSType type)
 {
     node->type = metaParser_->GetNodeType(type);
-    node->nativeSize = metaParser_->GetNativateSize(node, type);
+    node->nativeSize = metaParser_->GetNativateSize(GetNodeData(node), type);
     if (node->strId >= StringHashMap::CUSTOM_STRID_START) {
         StringKey stringKey = GetStringTable()->GetKeyByStringId(node->strId);
         std::string nodeName = GetStringTable()->GetStringByKey(stringKey);
@@ -447,86 +1080,94 @@ void RawHeapTranslateV1::FillNodes(Node *node, JSType type)
     }
 }
 
-void RawHeapTranslateV1::BuildEdges(Node *node, JSType type)
+const RawHeapTranslateV1::TypeVisit &RawHeapTranslateV1::GetTypeVisit(JSType type)
 {
+    TypeVisit &visit = typeVisits_[type];
+    if (visit.resolved) {
+        return visit;
+    }
+    // names are inserted in the order the edges of the first node used them, the string ids stay stable
+    visit.resolved = true;
+    MetaData *meta = metaParser_->GetMetaData(type);
     if (metaParser_->IsGlobalEnv(type)) {
-        BuildGlobalEnvEdges(node, type);
-    } else if (metaParser_->IsArray(type)) {
-        BuildArrayEdges(node, type);
+        visit.kind = VisitKind::GLOBAL_ENV;
+    } else if (meta == nullptr) {
+        visit.kind = VisitKind::NONE;
+    } else if (meta->IsArray()) {
+        visit.kind = VisitKind::ARRAY;
     } else {
-        BuildFieldEdges(node, type);
-        if (metaParser_->IsJSObject(type)) {
-            BuildJSObjectEdges(node, type);
+        visit.kind = metaParser_->IsJSObject(type) ? VisitKind::JS_OBJECT : VisitKind::FIELDS;
+        for (const auto &field : meta->fields) {
+            if (field.size == sizeof(uint64_t)) {
+                visit.fields.emplace_back(field.offset, InsertAndGetStringId(field.name));
+            }
+        }
+        if (visit.kind == VisitKind::JS_OBJECT) {
+            visit.endOffset = meta->endOffset;
+            visit.inlinePropertyStrId = InsertAndGetStringId("InlineProperty");
         }
     }
+    return visit;
 }
 
-void RawHeapTranslateV1::BuildGlobalEnvEdges(Node *node, JSType type)
-{
-    uint32_t offset = sizeof(uint64_t);
-    uint32_t index = 0;
-    while ((offset + sizeof(uint64_t)) <= node->size) {
-        uint64_t addr = ByteToU64(node->data + offset);
-        offset += sizeof(uint64_t);
-        EdgeType edgeType = GenerateEdgeTypeAndRemoveWeak(node, type, addr);
-        CreateEdge(node, addr, index++, edgeType);
-    }
-}
-
-void RawHeapTranslateV1::BuildArrayEdges(Node *node, JSType type)
+template <RawHeapTranslateV1::VisitKind kind>
+void RawHeapTranslateV1::BuildEdges(Node *node, const TypeVisit &visit)
 {
-    BitField *bitField = metaParser_->GetBitField();
-    uint32_t lengthOffset = bitField->taggedArrayLengthField.offset;
-    uint32_t dataOffset = bitField->taggedArrayDataField.offset;
-    uint32_t step = bitField->taggedArrayDataField.size;
-
-    uint32_t len = ByteToU32(node->data + lengthOffset);
-    if (step != sizeof(uint64_t) || len <= 0) {
-        return;
-    }
-
-    uint32_t offset = dataOffset;
-    uint32_t index = 0;
-    while (index < len && offset + step <= node->size) {
-        uint64_t addr = ByteToU64(node->data + offset);
-        offset += step;
-        EdgeType edgeType = GenerateEdgeTypeAndRemoveWeak(node, type, addr);
-        CreateEdge(node, addr, index++, edgeType);
+    const char *data = GetNodeData(node);
+    if (kind == VisitKind::GLOBAL_ENV) {
+        uint32_t count = node->size >= 2 * sizeof(uint64_t) ? node->size / sizeof(uint64_t) - 1 : 0;
+        BuildSlotEdges<false, true>(node, data + sizeof(uint64_t), count, 0);
+    } else if (kind == VisitKind::ARRAY) {
+        BitField *bitField = metaParser_->GetBitField();
+        uint32_t dataOffset = bitField->taggedArrayDataField.offset;
+        uint32_t len = ByteToU32(const_cast<char *>(data) + bitField->taggedArrayLengthField.offset);
+        if (bitField->taggedArrayDataField.size != sizeof(uint64_t) || len == 0 ||
+            dataOffset + sizeof(uint64_t) > node->size) {
+            return;
+        }
+        uint32_t count = std::min<uint32_t>(len, (node->size - dataOffset) / sizeof(uint64_t));
+        BuildSlotEdges<true, true>(node, data + dataOffset, count, 0);
+    } else if (kind == VisitKind::FIELDS || kind == VisitKind::JS_OBJECT) {
+        BuildFieldEdges(node, visit);
+        if (kind == VisitKind::JS_OBJECT && visit.endOffset + sizeof(uint64_t) <= node->size) {
+            uint32_t count = (node->size - visit.endOffset) / sizeof(uint64_t);
+            BuildSlotEdges<false, false>(node, data + visit.endOffset, count, visit.inlinePropertyStrId);
+        }
     }
 }
 
-void RawHeapTranslateV1::BuildFieldEdges(Node *node, JSType type)
+template <bool isElement, bool isIndexed>
+void RawHeapTranslateV1::BuildSlotEdges(Node *node, const char *slots, uint32_t count, StringId strId)
 {
-    MetaData *meta = metaParser_->GetMetaData(type);
-    if (meta == nullptr) {
-        return;
-    }
-
-    for (const auto &field : meta->fields) {
-        if (field.size != sizeof(uint64_t)) {
-            continue;
+    // tag bits of a block are tested together, only the references go on to the address lookup
+    constexpr uint32_t BLOCK_SLOTS = 32;
+    uint64_t values[BLOCK_SLOTS];
+    for (uint32_t begin = 0; begin < count; begin += BLOCK_SLOTS) {
+        uint32_t blockSize = std::min(BLOCK_SLOTS, count - begin);
+        uint32_t references = 0;
+        for (uint32_t i = 0; i < blockSize; ++i) {
+            values[i] = LoadU64(slots + (begin + i) * sizeof(uint64_t));
+            references |= static_cast<uint32_t>(IsReference(values[i])) << i;
+        }
+        while (references != 0) {
+            uint32_t i = static_cast<uint32_t>(__builtin_ctz(references));
+            references &= references - 1;
+            EdgeType type = isElement ? EdgeType::ELEMENT :
+                ((values[i] & TAG_WEAK_MASK) == TAG_WEAK ? EdgeType::WEAK : EdgeType::DEFAULT);
+            CreateEdge(node, values[i] & ~TAG_WEAK, isIndexed ? begin + i : strId, type);
         }
-        uint64_t addr = ByteToU64(node->data + field.offset);
-        EdgeType edgeType = GenerateEdgeTypeAndRemoveWeak(node, type, addr);
-        StringId strId = InsertAndGetStringId(field.name);
-        CreateEdge(node, addr, strId, edgeType);
     }
 }
 
-void RawHeapTranslateV1::BuildJSObjectEdges(Node *node, JSType type)
+void RawHeapTranslateV1::BuildFieldEdges(Node *node, const TypeVisit &visit)
 {
-    MetaData *meta = metaParser_->GetMetaData(type);
-    if (meta == nullptr) {
-        return;
-    }
-
-    StringId inlinePropertyStrId = InsertAndGetStringId("InlineProperty");
-    uint32_t offset = meta->endOffset;
-    while (offset + sizeof(uint64_t) <= node->size) {
-        uint64_t addr = ByteToU64(node->data + offset);
-        EdgeType edgeType = GenerateEdgeTypeAndRemoveWeak(node, type, addr);
-        CreateEdge(node, addr, inlinePropertyStrId, edgeType);
-        offset += sizeof(uint64_t);
+    const char *data = GetNodeData(node);
+    for (const auto &field : visit.fields) {
+        uint64_t value = LoadU64(data + field.first);
+        if (IsReference(value)) {
+            EdgeType type = (value & TAG_WEAK_MASK) == TAG_WEAK ? EdgeType::WEAK : EdgeType::DEFAULT;
+            CreateEdge(node, value & ~TAG_WEAK, field.second, type);
+        }
     }
 }
 
@@ -545,44 +1186,23 @@ void RawHeapTranslateV1::CreateHClassEdge(Node *node, Node *hclass)
     if (node->nodeId == hclass->nodeId) {
         return;
     }
-    static StringId hclassStrId = InsertAndGetStringId("hclass");
-    InsertEdge(hclass, hclassStrId, EdgeType::DEFAULT);
-    node->edgeCount++;
-}
-
-EdgeType RawHeapTranslateV1::GenerateEdgeTypeAndRemoveWeak(Node *node, JSType type, uint64_t &addr)
-{
-    EdgeType edgeType = EdgeType::DEFAULT;
-    if (IsWeak(addr)) {
-        RemoveWeak(addr);
-        edgeType = EdgeType::WEAK;
-    }
-    if (metaParser_->IsArray(type)) {
-        edgeType = EdgeType::ELEMENT;
+    if (hclassStrId_ == 0) {
+        hclassStrId_ = InsertAndGetStringId("hclass");
     }
-    return edgeType;
-}
-
-bool RawHeapTranslateV1::IsHeapObject(uint64_t addr)
-{
-    return ((addr & TAG_HEAPOBJECT_MASK) == 0U);
-}
-
-bool RawHeapTranslateV1::IsWeak(uint64_t addr)
-{
-    return (addr & TAG_WEAK_MASK) == TAG_WEAK;
+    InsertEdge(hclass, hclassStrId_, EdgeType::DEFAULT);
+    node->edgeCount++;
 }
 
-void RawHeapTranslateV1::RemoveWeak(uint64_t &addr)
+bool RawHeapTranslateV1::IsReference(uint64_t value)
 {
-    addr &= (~TAG_WEAK);
+    // a heap object address with the weak bit maybe set, the other tags mark primitives
+    return ((value & ~TAG_WEAK) & TAG_HEAPOBJECT_MASK) == 0U && value > TAG_WEAK;
 }
 
 RawHeapTranslateV2::~RawHeapTranslateV2()
 {
-    delete[] mem_;
     sections_.clear();
-    nodesMap_.clear();
+    addrIndex_.Clear();
 }
 
 bool RawHeapTranslateV2::Parse(FileReader &file, uint32_t rawheapFileSize)
@@ -593,12 +1213,28 @@ bool RawHeapTranslateV2::Parse(FileReader &file, uint32_t rawheapFileSize)
 
 bool RawHeapTranslateV2::Translate()
 {
+    ScopedPhase fillPhase(GetMonitor(), "node_fill");
     FillNodes();
+    fillPhase.addCounts(GetNodes()->size(), 0);
+    fillPhase.end();
+
+    ScopedPhase phase(GetMonitor(), "edge_build");
+    ReserveForTranslate();
     auto nodes = GetNodes();
     size_t size = nodes->size();
     for (size_t i = 1; i < size; ++i) {
-        Node *node = (*nodes)[i];
-        Node *hclass = GetNextEdgeTo();
+        if ((i & PROGRESS_MASK) == 0 && !ReportProgress("translate")) {
+            LOG_INFO_ << "translate canceled!";
+            return false;
+        }
+        Node *node = &(*nodes)[i];
+        // the memory of a string holds only its hclass, other objects a slot per 8 bytes after the hclass
+        uint32_t slotCount = 1;
+        if (!metaParser_->IsString(node->jsType) && node->size > 0) {
+            slotCount += (node->size - 1) / sizeof(uint64_t);
+        }
+        DecodeSlots(slotCount, refs_);
+        Node *hclass = refs_[0];
         if (hclass == nullptr) {
             LOG_ERROR_ << "missed hclass, node_id=" << node->nodeId;
             return false;
@@ -610,10 +1246,11 @@ bool RawHeapTranslateV2::Translate()
         if (metaParser_->IsString(node->jsType)) {
             continue;
         }
-        BuildEdges(node);
+        BuildEdges(node, refs_);
     }
 
     AddPrimitiveNodes();
+    phase.addCounts(GetEdges()->size(), 0);
     LOG_INFO_ << "success!";
     return true;
 }
@@ -645,6 +1282,7 @@ bool RawHeapTranslateV2::ReadStringTable(FileReader &file)
     }
 
     uint32_t strCnt = file.GetHeaderLeft();
+    ReserveStrings(strCnt);
     for (uint32_t i = 0; i < strCnt; ++i) {
         ParseStringTable(file);
     }
@@ -661,13 +1299,17 @@ bool RawHeapTranslateV2::ReadObjectTable(FileReader &file)
         return false;
     }
 
-    syntheticRoot_ = CreateNode();
+    ReserveNodes(file.GetHeaderLeft() + 1);  // 1: the synthetic root
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(file.GetHeaderLeft());
+    CreateNode();  // index 0 is the synthetic root, filled in AddSyntheticRootNode
     uint32_t tableSize = file.GetHeaderLeft() * file.GetHeaderRight();
     // 5: index in sections means the total size of object table
-    memSize_ = sections_[5] - tableSize - sizeof(uint64_t);
+    uint32_t memSize = sections_[5] - tableSize - sizeof(uint64_t);
+    uint32_t memOffset = sections_[4] + sizeof(uint64_t) + tableSize;
     std::vector<char> objTableData(tableSize);
-    mem_ = new char[memSize_];
-    if (!file.Read(objTableData.data(), tableSize) || !file.Read(mem_, memSize_)) {
+    if (!file.Read(objTableData.data(), tableSize) ||
+        !edgeStream_.Initialize(file.GetPath(), memOffset, memSize)) {
         LOG_ERROR_ << "read object table failed!";
         return false;
     }
@@ -681,16 +1323,28 @@ bool RawHeapTranslateV2::ReadObjectTable(FileReader &file)
             ByteToU32(tableData + sizeof(uint64_t) * 2),
             ByteToU32(tableData + sizeof(uint64_t) * 2 + sizeof(uint32_t))
         };
+        tableData += file.GetHeaderRight();
+        // objects left out of a sampled summary get no node, so the index and the string table stay small
+        if (!IsRead(table.nodeId)) {
+            continue;
+        }
 
         Node *node = CreateNode();
-        nodesMap_.emplace(table.syntheticAddr, node);
+        entries.emplace_back(table.syntheticAddr, node->index);
         node->size = table.size;
         node->nodeId = table.nodeId;
         node->nativeSize = table.nativeSize;
         node->jsType = static_cast<uint8_t>(table.type);
-        tableData += file.GetHeaderRight();
     }
 
+    // an address listed twice keeps its first node, the lower index sorts first
+    std::sort(entries.begin(), entries.end());
+    auto last = std::unique(entries.begin(), entries.end(),
+        [](const std::pair<uint64_t, uint32_t> &a, const std::pair<uint64_t, uint32_t> &b) {
+            return a.first == b.first;
+        });
+    entries.erase(last, entries.end());
+    addrIndex_.Build(entries);
     LOG_INFO_ << "objects table count " << file.GetHeaderLeft();
     return true;
 }
@@ -732,10 +1386,11 @@ bool RawHeapTranslateV2::ParseStringTable(FileReader &file)
 
 void RawHeapTranslateV2::AddSyntheticRootNode(std::vector<uint32_t> &roots)
 {
-    syntheticRoot_->nodeId = 1;      // 1: means root node
-    syntheticRoot_->type = 9;        // 9: means SYNTHETIC node type
-    syntheticRoot_->strId = InsertAndGetStringId("SyntheticRoot");
-    syntheticRoot_->edgeCount = roots.size();
+    Node *syntheticRoot = GetNode(0);
+    syntheticRoot->nodeId = 1;      // 1: means root node
+    syntheticRoot->type = 9;        // 9: means SYNTHETIC node type
+    syntheticRoot->strId = InsertAndGetStringId("SyntheticRoot");
+    syntheticRoot->edgeCount = roots.size();
 
     StringId strId = InsertAndGetStringId("-subroot-");
     EdgeType type = EdgeType::SHORTCUT;
@@ -750,48 +1405,53 @@ void RawHeapTranslateV2::AddSyntheticRootNode(std::vector<uint32_t> &roots)
 
 Node *RawHeapTranslateV2::FindNode(uint32_t addr)
 {
-    auto it = nodesMap_.find(addr);
-    if (it != nodesMap_.end()) {
-        return it->second;
+    uint32_t index = addrIndex_.Find(addr);
+    return index == AddressIndex::NOT_FOUND ? nullptr : GetNode(index);
+}
+
+bool RawHeapTranslateV2::ResolveTypes(const SummaryOptions & /* options */)
+{
+    // the object table already holds the type and native size, the object memory is never read
+    auto nodes = GetNodes();
+    for (auto it = nodes->begin() + 1; it != nodes->end(); ++it) {
+        if (it->type == DEFAULT_NODETYPE) {
+            it->type = metaParser_->GetNodeType(it->jsType);
+        }
     }
-    return nullptr;
+    return true;
 }
 
 void RawHeapTranslateV2::FillNodes()
 {
     auto nodes = GetNodes();
     for (auto it = nodes->begin() + 1; it != nodes->end(); it++) {
-        if ((*it)->type == DEFAULT_NODETYPE) {
-            (*it)->type = metaParser_->GetNodeType((*it)->jsType);
+        if (it->type == DEFAULT_NODETYPE) {
+            it->type = metaParser_->GetNodeType(it->jsType);
         }
 
-        if ((*it)->strId >= StringHashMap::CUSTOM_STRID_START || metaParser_->IsString((*it)->jsType)) {
+        if (it->strId >= StringHashMap::CUSTOM_STRID_START || metaParser_->IsString(it->jsType)) {
             continue;
         }
-        std::string name = metaParser_->GetTypeName((*it)->jsType);
+        std::string name = metaParser_->GetTypeName(it->jsType);
         std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-        (*it)->strId = InsertAndGetStringId(name);
+        it->strId = InsertAndGetStringId(name);
     }
 }
 
-void RawHeapTranslateV2::BuildEdges(Node *node)
+void RawHeapTranslateV2::BuildEdges(Node *node, std::vector<Node *> &refs)
 {
     if (metaParser_->IsArray(node->jsType)) {
-        BuildArrayEdges(node);
+        BuildArrayEdges(node, refs);
     } else {
-        std::vector<Node *> refs;
-        for (uint32_t offset = sizeof(uint64_t); offset < node->size; offset += sizeof(uint64_t)) {
-            refs.push_back(GetNextEdgeTo());
-        }
         BuildFieldEdges(node, refs);
     }
 }
 
-void RawHeapTranslateV2::BuildArrayEdges(Node *node)
+void RawHeapTranslateV2::BuildArrayEdges(Node *node, std::vector<Node *> &refs)
 {
     uint32_t index = 0;
-    for (uint32_t offset = sizeof(uint64_t); offset < node->size; offset += sizeof(uint64_t)) {
-        Node *ref = GetNextEdgeTo();
+    for (size_t slot = 1; slot < refs.size(); ++slot) {
+        Node *ref = refs[slot];
         if (ref == nullptr) {
             continue;
         }
@@ -808,12 +1468,13 @@ void RawHeapTranslateV2::BuildFieldEdges(Node *node, std::vector<Node *> &refs)
     }
 
     for (auto &field : meta->fields) {
-        size_t index = field.offset / sizeof(uint64_t) - 1;
-        if (index >= refs.size()) {
+        // slot 0 is the hclass, a field at offset 8 * k is slot k
+        size_t slot = field.offset / sizeof(uint64_t);
+        if (slot == 0 || slot >= refs.size()) {
             continue;
         }
 
-        Node *to = refs[index];
+        Node *to = refs[slot];
         if (to == nullptr) {
             continue;
         }
@@ -829,9 +1490,10 @@ void RawHeapTranslateV2::BuildFieldEdges(Node *node, std::vector<Node *> &refs)
 
 void RawHeapTranslateV2::BuildJSObjectEdges(Node *node, std::vector<Node *> &refs, uint32_t endOffset)
 {
-    size_t index = endOffset / sizeof(uint64_t) - 1;
-    for (size_t i = index; i < refs.size(); ++i) {
-        Node *ref = refs[i];
+    // inline properties start at slot endOffset / 8, an offset inside the hclass slot has none
+    size_t first = endOffset / sizeof(uint64_t);
+    for (size_t slot = first; first > 0 && slot < refs.size(); ++slot) {
+        Node *ref = refs[slot];
         if (ref == nullptr) {
             continue;
         }
@@ -845,30 +1507,52 @@ void RawHeapTranslateV2::CreateEdge(Node *node, Node *to, uint32_t nameOrIndex,
     node->edgeCount++;
 }
 
-Node *RawHeapTranslateV2::GetNextEdgeTo()
+void RawHeapTranslateV2::DecodeSlots(uint32_t count, std::vector<Node *> &refs)
 {
-    if (memPos_ + 1 > memSize_) {
-        return nullptr;
-    }
-
-    uint8_t tag = *reinterpret_cast<uint8_t *>(mem_ + memPos_++);
-    if ((tag & ZERO_VALUE) == ZERO_VALUE) {
-        return nullptr;
-    }
-
-    if ((tag & INTL_VALUE) == INTL_VALUE) {
-        memPos_ += sizeof(uint32_t);
-        return nullptr;
+    // a slot is 1 tag byte plus the payload, or a 4-byte address whose low byte is the tag. The slots are
+    // walked through a window with branchless lengths, the addresses are gathered and resolved in one pass
+    constexpr uint32_t WINDOW_SIZE = 256;
+    constexpr uint32_t MAX_SLOT_SIZE = 1 + sizeof(uint32_t);
+    refs.assign(count, nullptr);
+    slotAddrs_.clear();
+    uint32_t slot = 0;
+    while (slot < count) {
+        // most objects are a few slots, make readable only the bytes they can span
+        uint32_t need = static_cast<uint32_t>(std::min<uint64_t>(WINDOW_SIZE,
+            static_cast<uint64_t>(count - slot) * MAX_SLOT_SIZE));
+        bool atEnd = !edgeStream_.Ensure(need);
+        uint32_t window = std::min(edgeStream_.Available(), need);
+        if (window == 0) {
+            break;
+        }
+        const char *data = edgeStream_.Data();
+        uint32_t pos = 0;
+        while (slot < count && pos < window) {
+            // ZERO_VALUE: 1 byte, else INTL_VALUE: 1 + 4 bytes, else an address of 4 bytes
+            uint8_t tag = static_cast<uint8_t>(data[pos]);
+            uint32_t zero = (tag & ZERO_VALUE) == ZERO_VALUE;
+            uint32_t intl = (tag & INTL_VALUE) == INTL_VALUE;
+            uint32_t length = sizeof(uint32_t) + intl - zero * (sizeof(uint32_t) - 1 + intl);
+            if (pos + length > window) {
+                break;
+            }
+            if (length == sizeof(uint32_t)) {
+                slotAddrs_.emplace_back(slot, LoadU32(data + pos));
+            }
+            pos += length;
+            slot++;
+        }
+        edgeStream_.Skip(pos);
+        if (atEnd && slot < count && pos < window) {
+            // truncated slot at the end of the object memory
+            edgeStream_.SkipToEnd();
+            break;
+        }
     }
 
-    if ((tag & DOUB_VALUE) == DOUB_VALUE) {
-        memPos_ += sizeof(uint64_t);
-        return nullptr;
+    for (const auto &slotAddr : slotAddrs_) {
+        refs[slotAddr.first] = FindNode(slotAddr.second);
     }
-
-    Node *node = FindNode(ByteToU32(mem_ + memPos_ - 1));
-    memPos_ += sizeof(uint32_t) - 1;
-    return node;
 }
 
 EdgeType RawHeapTranslateV2::GenerateEdgeType(Node *node)
@@ -16,6 +16,8 @@
 #ifndef RAWHEAP_TRANSLATE_H
 #define RAWHEAP_TRANSLATE_H
 
+#include <memory>
+#include "analysis_monitor.h"
 #include "common.h"
 #include "metadata_parse.h"
 #include "string_hashmap.h"
@@ -25,6 +27,68 @@ class HeapDumpTestHelper;
 };
 
 namespace rawheap_translate {
+// objects of one JSType or one constructor name in a heap summary
+struct SummaryEntry {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t selfSize = 0;
+    uint64_t nativeSize = 0;
+    // half-width of the 95% confidence interval of each value, 0 when every object was counted
+    uint64_t countError = 0;
+    uint64_t selfSizeError = 0;
+    uint64_t nativeSizeError = 0;
+};
+
+// an object whose hash was requested, counted exactly even when sampling
+struct SummaryTarget {
+    uint32_t hash = 0;
+    uint64_t nodeId = 0;
+    std::string type;
+    std::string name;  // from the string table, empty for unnamed objects
+    uint64_t selfSize = 0;
+    uint64_t nativeSize = 0;
+};
+
+struct SummaryOptions {
+    // fraction of objects counted, chosen by node id so that repeated dumps sample the same objects;
+    // below 1 the values are estimates scaled up from the sample
+    double sampleRate = 1.0;
+    std::unordered_set<uint32_t> hashes {};  // always counted and listed in targets
+};
+
+// per-type and per-name object histograms, entries sorted by self size, largest first
+struct HeapSummary {
+    double sampleRate = 1.0;
+    uint64_t sampledCount = 0;  // objects actually counted, targets included
+    uint64_t objectCount = 0;
+    uint64_t selfSize = 0;
+    uint64_t nativeSize = 0;
+    uint64_t objectCountError = 0;
+    uint64_t selfSizeError = 0;
+    uint64_t nativeSizeError = 0;
+    std::vector<SummaryEntry> types {};
+    std::vector<SummaryEntry> names {};  // objects named in the string table, strings excluded
+    std::vector<SummaryTarget> targets {};
+};
+
+// one object of a dump, ids match across dumps of the same process; rawheap ids have the hash in the high 32 bits
+// removed, snapshot ids never carry it
+struct HeapObject {
+    uint64_t id = 0;
+    uint64_t size = 0;        // self size + native size
+    uint32_t classIndex = 0;  // into HeapObjects::classNames
+};
+
+// every object of a dump sorted by id, without the synthetic root and the id-0 hash nodes of a snapshot
+struct HeapObjects {
+    std::vector<HeapObject> objects {};
+    std::vector<std::string> classNames {};
+
+    // the group of an object as in the DevTools Constructor view, shared by rawheap and snapshot inputs:
+    // object and native nodes by name, hidden nodes as "(system)", other nodes as "(<node type>)"
+    static std::string ClassName(NodeType type, const std::string &name);
+};
+
 class RawHeap {
 public:
     RawHeap() : strTable_(new StringHashMap())
@@ -36,36 +100,84 @@ public:
 
     virtual bool Parse(FileReader &file, uint32_t rawheapFileSize) = 0;
     virtual bool Translate() = 0;
+    // fill jsType, node type and nativeSize of the nodes counted with these options as Translate would,
+    // no edges are built
+    virtual bool ResolveTypes(const SummaryOptions &options) = 0;
 
-    static bool TranslateRawheap(const std::string &inputPath, const std::string &outputPath);
+    // hashNodes: materialize object hashes as "Int:<hash>" nodes for DevTools, otherwise record them in
+    // the ark_hash_index side table which only this analyzer reads
+    static bool TranslateRawheap(const std::string &inputPath, const std::string &outputPath,
+                                 AnalysisMonitor *monitor = nullptr, bool hashNodes = true);
     static bool ParseMetaData(FileReader &file, MetaParser *parser);
     static RawHeap *ParseRawheap(FileReader &file, MetaParser *metaParser);
     static std::string ReadVersion(FileReader &file);
+    // Quick check: scan only the object table records for object hashes without building the heap graph.
+    // Matched hashes are added to found, stop early once every requested hash is found.
+    static bool ScanHashes(const std::string &inputPath, const std::unordered_set<uint32_t> &hashes,
+                           std::unordered_set<uint32_t> &found, AnalysisMonitor *monitor = nullptr);
+    // Summary: count objects and their self/native sizes per JSType and per constructor name from the object and
+    // string tables, skipping Translate() and serialization
+    static bool SummarizeRawheap(const std::string &inputPath, HeapSummary &summary,
+                                 AnalysisMonitor *monitor = nullptr, const SummaryOptions &options = SummaryOptions());
+    // Objects for diffing dumps: every object with its id, size and constructor name, read the same way as the
+    // summary
+    static bool CollectRawheapObjects(const std::string &inputPath, HeapObjects &objects,
+                                      AnalysisMonitor *monitor = nullptr);
 
-    std::vector<Node *>* GetNodes();
-    std::vector<Edge *>* GetEdges();
+    std::vector<Node>* GetNodes();
+    std::vector<Edge>* GetEdges();
     size_t GetNodeCount();
     size_t GetEdgeCount();
     StringHashMap* GetStringTable();
     std::string GetVersion();
+    void SetMonitor(AnalysisMonitor *monitor);
+    AnalysisMonitor *GetMonitor();
+    bool ReportProgress(const char *phase, uint64_t bytes = 0, uint64_t totalBytes = 0);
+    void SetHashNodes(bool hashNodes);
+    bool HasHashNodes();
+    // only objects counted with these options are read from the object table, for a sampled summary;
+    // versions that need every object to resolve types ignore it
+    void SetReadFilter(const SummaryOptions *options);
+    std::vector<std::pair<uint32_t, uint32_t>>* GetHashIndex();
 
 protected:
+    // the returned pointer is valid until the next CreateNode
     Node *CreateNode();
+    Node *GetNode(uint32_t index);
+    void ReserveNodes(size_t count);
+    void ReserveStrings(size_t count);
+    void ReserveForTranslate();
     void InsertEdge(Node *toNode, uint32_t indexOrStrId, EdgeType type);
     StringId InsertAndGetStringId(const std::string &str);
     void SetVersion(const std::string &version);
     void CreateHashEdge(Node *node);
     void AddPrimitiveNodes();
+    // nodes counted by the summary must have jsType and nativeSize filled, the synthetic root at index 0 is skipped
+    void FillSummary(MetaParser *metaParser, const SummaryOptions &options, HeapSummary &summary);
+    // every node except the synthetic root, types must be resolved for all of them
+    void FillObjects(MetaParser *metaParser, HeapObjects &objects);
+    static bool IsSummarized(uint64_t nodeId, const SummaryOptions &options);
+    bool IsRead(uint64_t nodeId);
 
+    // parse the object and string tables of a rawheap file for the summary and the diff
+    static std::unique_ptr<RawHeap> ParseTables(FileReader &file, MetaParser &metaParser, const std::string &inputPath,
+                                                AnalysisMonitor *monitor, const SummaryOptions *readFilter = nullptr);
     static bool ReadSectionInfo(FileReader &file, uint32_t offset, std::vector<uint32_t> &section);
+    static bool ScanObjectTableHashes(FileReader &file, uint32_t offset, const std::unordered_set<uint32_t> &hashes,
+                                      std::unordered_set<uint32_t> &found);
 
 private:
     StringHashMap *strTable_ {nullptr};
-    std::vector<Node *> primitiveNodes_ {};
-    std::vector<Node *> nodes_ {};
-    std::vector<Edge *> edges_ {};
+    std::vector<Node> primitiveNodes_ {};
+    std::vector<Node> nodes_ {};
+    std::vector<Edge> edges_ {};
     std::string version_;
     uint32_t nodeIndex_ {0};
+    AnalysisMonitor *monitor_ {nullptr};
+    StringId hashStrId_ {0};  // ids belong to this instance's string table, 0 means not inserted yet
+    bool hashNodes_ {true};
+    std::vector<std::pair<uint32_t, uint32_t>> hashIndex_ {};  // (hash, node index) when hashNodes_ is false
+    const SummaryOptions *readFilter_ {nullptr};
 
 #ifdef OHOS_UNIT_TEST
     std::unordered_set<uint32_t> hashSet_ {};
@@ -74,6 +186,48 @@ private:
     friend class panda::test::HeapDumpTestHelper;
 };
 
+// Read-only address -> value lookup for V1 and V2 objects: a sorted address array plus a bucket table over the
+// address range (about one address per bucket), so a lookup reads one bucket and runs a short branchless
+// search. It takes a fraction of the memory of a node-based hash map for tens of millions of objects.
+class AddressIndex {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    // entries must be sorted by address without duplicates
+    void Build(const std::vector<std::pair<uint64_t, uint32_t>> &entries);
+    // replace every value v with values[v]
+    void Remap(const std::vector<uint32_t> &values);
+    void Clear();
+
+    uint32_t Find(uint64_t addr) const
+    {
+        uint64_t bucket = (addr - base_) >> shift_;
+        if (addr < base_ || bucket >= bucketCount_) {
+            return NOT_FOUND;
+        }
+        const uint64_t *first = keys_.data() + buckets_[bucket];
+        size_t len = buckets_[bucket + 1] - buckets_[bucket];
+        if (len == 0) {
+            return NOT_FOUND;
+        }
+        // branchless: first ends on the last address not greater than addr
+        while (len > 1) {
+            size_t half = len / 2;
+            first += (first[half] <= addr) ? half : 0;
+            len -= half;
+        }
+        return *first == addr ? values_[first - keys_.data()] : NOT_FOUND;
+    }
+
+private:
+    std::vector<uint64_t> keys_ {};
+    std::vector<uint32_t> values_ {};
+    std::vector<uint32_t> buckets_ {0};  // bucket b holds keys_[buckets_[b], buckets_[b + 1])
+    uint64_t base_ {0};
+    uint64_t bucketCount_ {0};
+    uint32_t shift_ {0};
+};
+
 class RawHeapTranslateV1 : public RawHeap {
 public:
     RawHeapTranslateV1(MetaParser *meta) : metaParser_(meta) {}
@@ -81,6 +235,7 @@ public:
 
     bool Parse(FileReader &file, uint32_t rawheapFileSize) override;
     bool Translate() override;
+    bool ResolveTypes(const SummaryOptions &options) override;
 
 private:
     struct AddrTableItem {
@@ -90,36 +245,62 @@ private:
         uint32_t offset = 0;
     };
 
+    // an object table item kept until its node is created
+    struct ObjectItem {
+        uint64_t addr = 0;
+        uint64_t id = 0;
+        uint32_t size = 0;
+        char *data {nullptr};
+    };
+
     bool ReadRootTable(FileReader &file);
     bool ReadStringTable(FileReader &file);
     bool ReadObjectTable(FileReader &file, uint32_t offset, uint32_t totalSize);
     bool ParseStringTable(FileReader &file);
     void AddSyntheticRootNode(std::vector<uint64_t> &roots);
     void SetNodeStringId(const std::vector<uint64_t> &objects, StringId strId);
+    void BuildAddressIndex();
+    void CreateObjectNodes();
     Node* FindOrCreateNode(uint64_t addr);
     Node* FindNode(uint64_t addr);
+    char *GetNodeData(Node *node);
+
+    enum class VisitKind : uint8_t { NONE, FIELDS, JS_OBJECT, ARRAY, GLOBAL_ENV, COUNT };
+
+    // how the slots of one JSType are visited, resolved from the metadata on the first node of the type
+    struct TypeVisit {
+        bool resolved = false;
+        VisitKind kind = VisitKind::NONE;
+        std::vector<std::pair<uint32_t, StringId>> fields {};  // offset and name of the tagged fields
+        uint32_t endOffset = 0;  // inline properties of a JSObject start here
+        StringId inlinePropertyStrId = 0;
+    };
 
     void FillNodes(Node *node, JSType type);
-    void BuildEdges(Node *node, JSType type);
-    void BuildGlobalEnvEdges(Node *node, JSType type);
-    void BuildArrayEdges(Node *node, JSType type);
-    void BuildFieldEdges(Node *node, JSType type);
-    void BuildJSObjectEdges(Node *node, JSType type);
+    const TypeVisit &GetTypeVisit(JSType type);
+    template <VisitKind kind>
+    void BuildEdges(Node *node, const TypeVisit &visit);
+    template <bool isElement, bool isIndexed>
+    void BuildSlotEdges(Node *node, const char *slots, uint32_t count, StringId strId);
+    void BuildFieldEdges(Node *node, const TypeVisit &visit);
     void CreateEdge(Node *node, uint64_t addr, uint32_t nameOrIndex, EdgeType type);
     void CreateHClassEdge(Node *node, Node *hclass);
-    EdgeType GenerateEdgeTypeAndRemoveWeak(Node *node, JSType type, uint64_t &addr);
 
-    static bool IsHeapObject(uint64_t addr);
-    static bool IsWeak(uint64_t addr);
-    static void RemoveWeak(uint64_t &addr);
+    static bool IsReference(uint64_t value);
     static constexpr uint64_t TAG_WEAK = 0x01ULL;
     static constexpr uint64_t TAG_WEAK_MASK = 0x01ULL;
     static constexpr uint64_t TAG_HEAPOBJECT_MASK = (0xFFFFULL << 48) | 0x02ULL | 0x04ULL;  // 48 means 6 byte shift
 
     MetaParser *metaParser_ {nullptr};
     std::vector<char *> mem_ {};
+    std::vector<char *> nodeData_ {};  // object memory of each node by node index, V2 nodes need none
     std::vector<uint32_t> sections_ {};
-    std::unordered_map<uint64_t, Node *> nodesMap_ {};
+    // address -> object item while parsing, address -> node index afterwards
+    AddressIndex addrIndex_ {};
+    std::vector<ObjectItem> objects_ {};  // items of all object tables, released after parsing
+    std::vector<uint32_t> objectNodes_ {};  // object item -> node index, NOT_FOUND until created
+    StringId hclassStrId_ {0};
+    std::vector<TypeVisit> typeVisits_ {};  // by JSType
     friend class panda::test::HeapDumpTestHelper;
 };
 
@@ -130,6 +311,7 @@ public:
 
     bool Parse(FileReader &file, uint32_t rawheapFileSize) override;
     bool Translate() override;
+    bool ResolveTypes(const SummaryOptions &options) override;
 
 private:
     struct AddrTableItemV2 {
@@ -148,21 +330,20 @@ private:
     Node* FindNode(uint32_t addr);
 
     void FillNodes();
-    void BuildEdges(Node *node);
-    void BuildArrayEdges(Node *node);
+    void BuildEdges(Node *node, std::vector<Node *> &refs);
+    void BuildArrayEdges(Node *node, std::vector<Node *> &refs);
     void BuildFieldEdges(Node *node, std::vector<Node *> &refs);
     void BuildJSObjectEdges(Node *node, std::vector<Node *> &refs, uint32_t endOffset);
     void CreateEdge(Node *node, Node *to, uint32_t nameOrIndex, EdgeType type);
-    Node* GetNextEdgeTo();
+    void DecodeSlots(uint32_t count, std::vector<Node *> &refs);
     EdgeType GenerateEdgeType(Node *node);
 
     MetaParser *metaParser_ {nullptr};
-    char *mem_ {};
-    uint32_t memSize_ {0};
-    uint32_t memPos_ {0};
+    SequentialReader edgeStream_ {};  // object memory is consumed strictly in order, read it through a fixed buffer
+    std::vector<Node *> refs_ {};  // slots of the current object, slot 0 is the hclass; reused across objects
+    std::vector<std::pair<uint32_t, uint32_t>> slotAddrs_ {};  // slot and address of the decoded references
     std::vector<uint32_t> sections_ {};
-    std::unordered_map<uint32_t, Node *> nodesMap_ {};
-    Node *syntheticRoot_ {nullptr};
+    AddressIndex addrIndex_ {};  // synthetic address -> node index
     friend class panda::test::HeapDumpTestHelper;
 };
 }  // namespace rawheap_translate
@@ -74,13 +74,25 @@ bool HeapSnapshotJSONSerializer::Serialize(RawHeap *rawheap, StreamWriter *write
     LOG_INFO_ << "start to serialize!";
     // Serialize Node/Edge/String-Table
     SerializeSnapshotHeader(rawheap, writer);     // 1.
+    if (!rawheap->ReportProgress("serialize")) {
+        return false;
+    }
     SerializeNodes(rawheap, writer);              // 2.
+    if (!rawheap->ReportProgress("serialize")) {
+        return false;
+    }
     SerializeEdges(rawheap, writer);              // 3.
+    if (!rawheap->ReportProgress("serialize")) {
+        return false;
+    }
 
     writer->WriteString("\"trace_function_infos\":[],");  // 4.
     writer->WriteString("\"trace_tree\":[],");
     writer->WriteString("\"samples\":[],");
     writer->WriteString("\"locations\":[],\n");
+    if (!rawheap->HasHashNodes()) {
+        SerializeHashIndex(rawheap, writer);
+    }
 
     SerializeStringTable(rawheap, writer);        // 8.
     SerializerSnapshotClosure(writer);   // 9.
@@ -133,25 +145,25 @@ void HeapSnapshotJSONSerializer::SerializeNodes(RawHeap *rawheap, StreamWriter *
     auto nodes = rawheap->GetNodes();
     writer->WriteString("\"nodes\":[");  // Section Header
     size_t i = 0;
-    for (auto node : *nodes) {
+    for (const auto &node : *nodes) {
         if (i > 0) {
             writer->WriteChar(',');  // add comma except first line
         }
-        writer->WriteNumber(node->type);  // 1.
+        writer->WriteNumber(node.type);  // 1.
         writer->WriteChar(',');
-        writer->WriteNumber(node->strId);                      // 2.
+        writer->WriteNumber(node.strId);                      // 2.
         writer->WriteChar(',');
-        writer->WriteNumber(node->nodeId);                                                  // 3.
+        writer->WriteNumber(node.nodeId);                                                  // 3.
         writer->WriteChar(',');
-        writer->WriteNumber(node->size);                                            // 4.
+        writer->WriteNumber(node.size);                                            // 4.
         writer->WriteChar(',');
-        writer->WriteNumber(node->edgeCount);                                           // 5.
+        writer->WriteNumber(node.edgeCount);                                           // 5.
         writer->WriteChar(',');
         writer->WriteNumber(0);                                        // 6.
         writer->WriteChar(',');
         writer->WriteChar('0');                                                              // 7.detachedness default 0
         writer->WriteChar(',');
-        writer->WriteNumber(node->nativeSize);
+        writer->WriteNumber(node.nativeSize);
         if (i == nodes->size() - 1) {    // add comma at last the line
             writer->WriteString("],\n"); // 7. detachedness default
         } else {
@@ -166,26 +178,46 @@ void HeapSnapshotJSONSerializer::SerializeEdges(RawHeap *rawheap, StreamWriter *
     auto edges = rawheap->GetEdges();
     writer->WriteString("\"edges\":[");
     size_t i = 0;
-    for (auto edge : *edges) {
+    for (const auto &edge : *edges) {
         if (i > 0) {  // add comma except the first line
             writer->WriteChar(',');
         }
-        writer->WriteNumber(static_cast<int>(edge->type));          // 1.
+        writer->WriteNumber(static_cast<int>(edge.type));          // 1.
         writer->WriteChar(',');
-        writer->WriteNumber(static_cast<int>(edge->nameOrIndex));  // 2. Use StringId
+        writer->WriteNumber(static_cast<int>(edge.nameOrIndex));  // 2. Use StringId
         writer->WriteChar(',');
 
         if (i == edges->size() - 1) {  // add comma at last the line
-            writer->WriteNumber(edge->to->index * NODE_FIELD_COUNT);  // 3.
+            writer->WriteNumber(static_cast<uint64_t>(edge.to) * NODE_FIELD_COUNT);  // 3.
             writer->WriteString("],\n");
         } else {
-            writer->WriteNumber(edge->to->index * NODE_FIELD_COUNT);    // 3.
+            writer->WriteNumber(static_cast<uint64_t>(edge.to) * NODE_FIELD_COUNT);    // 3.
             writer->WriteChar('\n');
         }
         i++;
     }
 }
 
+// Not part of the DevTools format: flat (hash, node_index) pairs replacing the "Int:<hash>" nodes
+void HeapSnapshotJSONSerializer::SerializeHashIndex(RawHeap *rawheap, StreamWriter *writer)
+{
+    auto hashIndex = rawheap->GetHashIndex();
+    writer->WriteString("\"ark_hash_index\":[");
+    size_t i = 0;
+    for (const auto &entry : *hashIndex) {
+        if (i > 0) {
+            writer->WriteChar(',');
+        }
+        writer->WriteNumber(entry.first);
+        writer->WriteChar(',');
+        writer->WriteNumber(entry.second);
+        if ((++i & 0xF) == 0) {
+            writer->WriteChar('\n');
+        }
+    }
+    writer->WriteString("],\n");
+}
+
 void HeapSnapshotJSONSerializer::SerializeStringTable(RawHeap *rawheap, StreamWriter *writer)
 {
     auto stringTable = rawheap->GetStringTable();
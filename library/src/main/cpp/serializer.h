@@ -84,6 +84,7 @@ private:
     static void SerializeSnapshotHeader(RawHeap *rawheap, StreamWriter *writer);
     static void SerializeNodes(RawHeap *rawheap, StreamWriter *writer);
     static void SerializeEdges(RawHeap *rawheap, StreamWriter *writer);
+    static void SerializeHashIndex(RawHeap *rawheap, StreamWriter *writer);
     static void SerializeStringTable(RawHeap *rawheap, StreamWriter *writer);
     static void SerializeString(const char *str, StreamWriter *writer);
     static void SerializerSnapshotClosure(StreamWriter *writer);
@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <functional>
+#include <thread>
+#include "snapshot_index.h"
+
+namespace {
+const char INDEX_MAGIC[8] = {'L', 'G', 'S', 'N', 'P', 'I', 'D', 'X'};
+// HeapNode/Edge等结构布局变化时需要递增
+const uint32_t INDEX_VERSION = 1;
+const uint32_t INDEX_BYTE_ORDER = 0x01020304;
+const uint64_t INDEX_ALIGNMENT = 8;
+
+struct IndexFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t snapshotSize;
+    int64_t snapshotMtimeNs;
+    uint32_t sectionCount;
+    uint32_t reserved;
+};
+
+struct IndexSectionEntry {
+    uint32_t kind;
+    uint32_t elemSize;
+    uint64_t offset;
+    uint64_t count;
+};
+
+uint64_t alignUp(uint64_t value) {
+    return (value + INDEX_ALIGNMENT - 1) & ~(INDEX_ALIGNMENT - 1);
+}
+
+bool writeAll(FILE* fp, const void* data, size_t size) {
+    return size == 0 || fwrite(data, 1, size, fp) == size;
+}
+}
+
+bool SnapshotFileStamp::read(const std::string& path, SnapshotFileStamp& stamp) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    stamp.size = static_cast<uint64_t>(st.st_size);
+    stamp.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+std::string getSnapshotIndexPath(const std::string& snapshotPath) {
+    return snapshotPath + ".idx";
+}
+
+bool SnapshotIndexWriter::write(const std::string& indexPath, const SnapshotFileStamp& stamp) const {
+    IndexFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.byteOrder = INDEX_BYTE_ORDER;
+    header.snapshotSize = stamp.size;
+    header.snapshotMtimeNs = stamp.mtimeNs;
+    header.sectionCount = static_cast<uint32_t>(sections.size());
+
+    // 数据段按8字节对齐，映射后可直接按元素类型访问
+    std::vector<IndexSectionEntry> entries(sections.size());
+    uint64_t offset = alignUp(sizeof(IndexFileHeader) + sizeof(IndexSectionEntry) * sections.size());
+    for (size_t i = 0; i < sections.size(); i++) {
+        entries[i].kind = static_cast<uint32_t>(sections[i].kind);
+        entries[i].elemSize = sections[i].elemSize;
+        entries[i].offset = offset;
+        entries[i].count = sections[i].count;
+        offset = alignUp(offset + sections[i].count * sections[i].elemSize);
+    }
+
+    // 多个线程可能同时为同一快照写索引，临时文件按线程区分
+    std::string tmpPath = indexPath + ".tmp" +
+                          std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    FILE* fp = fopen(tmpPath.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    bool ok = writeAll(fp, &header, sizeof(header)) &&
+              writeAll(fp, entries.data(), sizeof(IndexSectionEntry) * entries.size());
+    uint64_t written = sizeof(IndexFileHeader) + sizeof(IndexSectionEntry) * entries.size();
+    const char padding[INDEX_ALIGNMENT] = {0};
+    for (size_t i = 0; ok && i < sections.size(); i++) {
+        ok = writeAll(fp, padding, entries[i].offset - written) &&
+             writeAll(fp, sections[i].data, sections[i].count * sections[i].elemSize);
+        written = entries[i].offset + sections[i].count * sections[i].elemSize;
+    }
+    ok = ok && writeAll(fp, padding, offset - written);
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmpPath.c_str(), indexPath.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+SnapshotIndexReader::~SnapshotIndexReader() {
+    if (base != nullptr) {
+        munmap(base, length);
+    }
+}
+
+bool SnapshotIndexReader::open(const std::string& indexPath, const SnapshotFileStamp& stamp) {
+    int fd = ::open(indexPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(IndexFileHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    const IndexFileHeader* header = static_cast<const IndexFileHeader*>(mapped);
+    bool valid = memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+                 header->version == INDEX_VERSION &&
+                 header->byteOrder == INDEX_BYTE_ORDER &&
+                 header->snapshotSize == stamp.size &&
+                 header->snapshotMtimeNs == stamp.mtimeNs &&
+                 sizeof(IndexFileHeader) + sizeof(IndexSectionEntry) * static_cast<uint64_t>(header->sectionCount) <= size;
+    // 校验每个数据段都在文件范围内，避免截断的索引导致越界访问
+    const IndexSectionEntry* entries = reinterpret_cast<const IndexSectionEntry*>(header + 1);
+    for (uint32_t i = 0; valid && i < header->sectionCount; i++) {
+        const IndexSectionEntry& entry = entries[i];
+        valid = entry.offset % INDEX_ALIGNMENT == 0 && entry.offset <= size && entry.elemSize > 0 &&
+                entry.count <= (size - entry.offset) / entry.elemSize;
+    }
+    if (!valid) {
+        munmap(mapped, size);
+        return false;
+    }
+
+    if (base != nullptr) {
+        munmap(base, length);
+    }
+    base = mapped;
+    length = size;
+    return true;
+}
+
+const void* SnapshotIndexReader::findSection(IndexSection kind, uint32_t elemSize, uint64_t& count) const {
+    if (base == nullptr) {
+        return nullptr;
+    }
+    const IndexFileHeader* header = static_cast<const IndexFileHeader*>(base);
+    const IndexSectionEntry* entries = reinterpret_cast<const IndexSectionEntry*>(header + 1);
+    for (uint32_t i = 0; i < header->sectionCount; i++) {
+        if (entries[i].kind == static_cast<uint32_t>(kind)) {
+            if (entries[i].elemSize != elemSize) {
+                return nullptr;
+            }
+            count = entries[i].count;
+            return static_cast<const char*>(base) + entries[i].offset;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,130 @@
+#ifndef SNAPSHOT_INDEX_H
+#define SNAPSHOT_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// sidecar索引中的数据段类型
+enum class IndexSection : uint32_t {
+    NODES = 1,
+    EDGES,
+    FIRST_EDGE_INDEXES,
+    FIRST_RETAINER_INDEXES,
+    RETAINING_NODES,
+    RETAINING_EDGES,
+    GC_ROOT_FLAGS,
+    NODE_ID_INDEX,
+    STRING_OFFSETS,
+    STRING_DATA,
+    HASH_INDEX,
+    ROOT_DISTANCES,
+    DOMINATORS,      // 可选：首次计算支配树后补写
+    RETAINED_SIZES
+};
+
+// 快照文件的大小和修改时间，用于判断sidecar是否过期
+struct SnapshotFileStamp {
+    uint64_t size;
+    int64_t mtimeNs;
+
+    SnapshotFileStamp() : size(0), mtimeNs(0) {}
+
+    static bool read(const std::string& path, SnapshotFileStamp& stamp);
+
+    bool operator==(const SnapshotFileStamp& other) const {
+        return size == other.size && mtimeNs == other.mtimeNs;
+    }
+};
+
+// sidecar索引文件路径：与快照文件同目录
+std::string getSnapshotIndexPath(const std::string& snapshotPath);
+
+// 只读数组：数据由自身持有，或直接指向sidecar索引的映射内存
+template <typename T>
+class IndexArray {
+public:
+    IndexArray() : ptr(nullptr), count(0) {}
+    IndexArray(const IndexArray&) = delete;
+    IndexArray& operator=(const IndexArray&) = delete;
+
+    void assign(std::vector<T>&& values) {
+        owned = std::move(values);
+        ptr = owned.data();
+        count = owned.size();
+    }
+
+    void map(const T* data, size_t size) {
+        std::vector<T>().swap(owned);
+        ptr = data;
+        count = size;
+    }
+
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T* data() const { return ptr; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    // 自己持有的堆内存字节数，映射的数据不计入
+    size_t ownedBytes() const { return owned.size() * sizeof(T); }
+
+private:
+    std::vector<T> owned;
+    const T* ptr;
+    size_t count;
+};
+
+// sidecar索引写入器：先收集各数据段，再写入临时文件并重命名，避免读到写了一半的索引
+class SnapshotIndexWriter {
+public:
+    template <typename T>
+    void addSection(IndexSection kind, const IndexArray<T>& array) {
+        sections.push_back({kind, static_cast<uint32_t>(sizeof(T)), array.data(), array.size()});
+    }
+
+    bool write(const std::string& indexPath, const SnapshotFileStamp& stamp) const;
+
+private:
+    struct PendingSection {
+        IndexSection kind;
+        uint32_t elemSize;
+        const void* data;
+        uint64_t count;
+    };
+    std::vector<PendingSection> sections;
+};
+
+// sidecar索引读取器：mmap整个文件，数据段直接指向映射内存
+class SnapshotIndexReader {
+public:
+    SnapshotIndexReader() : base(nullptr), length(0) {}
+    ~SnapshotIndexReader();
+    SnapshotIndexReader(const SnapshotIndexReader&) = delete;
+    SnapshotIndexReader& operator=(const SnapshotIndexReader&) = delete;
+
+    // 文件不存在、版本不符或快照已变化时返回false
+    bool open(const std::string& indexPath, const SnapshotFileStamp& stamp);
+
+    template <typename T>
+    bool mapSection(IndexSection kind, IndexArray<T>& array) const {
+        uint64_t count = 0;
+        const void* data = findSection(kind, static_cast<uint32_t>(sizeof(T)), count);
+        if (data == nullptr) {
+            return false;
+        }
+        array.map(static_cast<const T*>(data), static_cast<size_t>(count));
+        return true;
+    }
+
+    size_t mappedSize() const { return length; }
+
+private:
+    const void* findSection(IndexSection kind, uint32_t elemSize, uint64_t& count) const;
+
+    void* base;
+    size_t length;
+};
+
+#endif // SNAPSHOT_INDEX_H
@@ -45,6 +45,13 @@ StringId StringHashMap::InsertStrAndGetStringId(const std::string &str)
     }
 }
 
+void StringHashMap::Reserve(size_t count)
+{
+    orderedKey_.reserve(count);
+    indexMap_.reserve(count);
+    hashmap_.reserve(count);
+}
+
 StringKey StringHashMap::GenerateStringKey(const std::string &str) const
 {
     return std::hash<std::string>{} (str);
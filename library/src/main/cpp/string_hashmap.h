@@ -16,6 +16,7 @@
 #ifndef RAWHEAP_TRANSLATE_STRING_HASHMAP_H
 #define RAWHEAP_TRANSLATE_STRING_HASHMAP_H
 
+#include <unordered_map>
 #include "common.h"
 
 namespace rawheap_translate {
@@ -44,6 +45,10 @@ public:
     std::string GetStringByKey(StringKey key) const;
     StringKey GetKeyByStringId(StringId stringId) const;
     StringId InsertStrAndGetStringId(const std::string &cstrArg);
+    /*
+     * Reserve room for count strings in total, avoids rehashing while the tables are filled
+     */
+    void Reserve(size_t count);
     size_t GetCapcity() const
     {
         return orderedKey_.size();
@@ -14,9 +14,12 @@ export interface HashInfo{
   name:string
 }
 
+// 节点ID，超出Number安全整数范围(2^53 - 1)时为BigInt
+export type NodeId = number | bigint;
+
 // 引用链节点接口
 export interface ReferenceChainNode {
-  nodeId: number;
+  nodeId: NodeId;
   name: string;
   type: string;
   path: string;
@@ -33,6 +36,67 @@ export interface NodeRef {
   name: string;
   /** 到GC根的引用链 */
   ref: ReferenceChain[];
+  /** 节点自身大小(self_size + native_size) */
+  selfSize?: number;
+  /** 节点支配的所有对象大小之和，即释放该节点可回收的内存 */
+  retainedSize?: number;
+}
+
+/**
+ * 节点保留大小信息接口
+ */
+export interface RetainedInfo {
+  /** 节点ID */
+  nodeId: NodeId;
+  /** 节点自身大小(self_size + native_size) */
+  selfSize: number;
+  /** 节点支配的所有对象大小之和 */
+  retainedSize: number;
+  /** 直接支配者的节点ID，不可达时为0 */
+  dominatorId: NodeId;
+  /** 从根节点出发的最短引用距离，不可达时为-1 */
+  distance: number;
+}
+
+/**
+ * 分析进度
+ */
+export interface AnalysisProgress {
+  /** 当前阶段：hash_scan/read/translate/serialize/parse/index/query，批量分析时为batch */
+  phase: string;
+  /** 已处理的字节数 */
+  bytes: number;
+  /** 输入文件总字节数，未知时为0 */
+  totalBytes: number;
+  /** 已处理的节点数，query阶段为已完成的目标数，batch阶段为已完成的dump数 */
+  nodes: number;
+  /** 已处理的边数 */
+  edges: number;
+}
+
+// 取消令牌，调用cancel后正在进行的分析会尽快以"分析已取消"失败
+export class CancelToken {
+  cancel(): void;
+  isCancelled(): boolean;
+}
+
+// 分析选项
+export interface AnalyzeOptions {
+  /** 进度回调，在JS线程中调用 */
+  onProgress?: (progress: AnalysisProgress) => void;
+  /** 取消令牌 */
+  cancelToken?: CancelToken;
+  /**
+   * 每找到一个目标的引用链就在JS线程中回调一次，早于Promise完成；此时还没有计算支配树，retainedSize为0，
+   * Promise的结果中才有。packed变体不调用，改用onPackedResult
+   */
+  onResult?: (nodeRef: NodeRef) => void;
+  /** 仅packed变体：同onResult，参数为只含这一个目标的紧凑编码，用PackedNodeRefs解码 */
+  onPackedResult?: (fragment: ArrayBuffer) => void;
+  /** 本次调用的分阶段统计，在JS线程中于Promise完成前回调一次 */
+  onStats?: (stats: AnalysisStats) => void;
+  /** 仅rawAnalyzeHash：先扫描rawheap对象表，目标都不存在时不转换直接返回空结果 */
+  quickCheck?: boolean;
 }
 
 // 引用链接口
@@ -43,19 +107,258 @@ export interface ReferenceChain {
 }
 
 // 创建内存快照分析任务
-export const createTask: (filePath: string) => number;
+export const createTask: (filePath: string, options?: StatsOptions) => number;
+
+// 在工作线程中创建内存快照分析任务，不阻塞UI线程
+export const createTaskAsync: (filePath: string, options?: StatsOptions) => Promise<number>;
 
 // 销毁内存快照分析任务
 export const destroyTask: (taskId: number) => boolean;
 
+// 设置已解析快照缓存的内存预算(字节)，为0时不缓存，默认256MB；从sidecar索引映射的数据不计入
+export const setSnapshotCacheBudget: (bytes: number) => void;
+
+// 工作线程池配置
+export interface WorkerPoolOptions {
+  /** 最大工作线程数，不设置或为0时为CPU核数-1 */
+  maxThreads?: number;
+  /** 为true时工作线程降低优先级，并在大小核设备上只使用小核 */
+  background?: boolean;
+}
+
+// 配置转换和分析共用的工作线程池
+export const configureWorkerPool: (options: WorkerPoolOptions) => void;
+
+/**
+ * 单个阶段的统计，同一阶段多次执行时累加
+ * 阶段：metadata_parse/section_read/node_fill/edge_build/serialize/json_parse/index_build/index_load/index_save/bfs/dominators/summary
+ */
+export interface PhaseStats {
+  name: string;
+  /** 执行次数 */
+  calls: number;
+  /** 墙钟时间(毫秒)，并行执行时为各线程之和 */
+  wallMs: number;
+  /** CPU时间(毫秒) */
+  cpuMs: number;
+  /** 处理的节点/边数 */
+  items: number;
+  /** 读写的字节数 */
+  bytes: number;
+}
+
+/**
+ * 一次调用的分阶段统计
+ */
+export interface AnalysisStats {
+  /** 产生该统计的调用 */
+  call: string;
+  /** 调用结束的时间戳(毫秒) */
+  timestamp: number;
+  /** 调用结束时进程的常驻内存(KB) */
+  rssKb: number;
+  /** 调用期间(各阶段结束时采样)常驻内存的最大值比调用开始时多出的部分(KB)，同时进行的调用会互相计入 */
+  rssDeltaKb: number;
+  phases: PhaseStats[];
+}
+
+// 只接收统计的调用选项
+export interface StatsOptions {
+  /** 本次调用的分阶段统计，同步调用在返回前、异步调用在Promise完成前于JS线程中回调一次 */
+  onStats?: (stats: AnalysisStats) => void;
+}
+
+// 获取JS线程中最近完成的一次调用的分阶段统计；只在同步调用刚返回时可靠，有异步调用进行中时用各调用选项中的onStats
+export const getLastStats: () => AnalysisStats | undefined;
+
+// 设置统计输出文件，每次调用结束后追加一行JSON，为空字符串时不输出
+export const setStatsDumpPath: (path: string) => void;
+
 // 获取到GC根的最短引用链
-export const getShortestPathToGCRoot: (taskId: number, name: string, maxDepth?: number) => ReferenceChain[];
+export const getShortestPathToGCRoot: (taskId: number, name: string, maxDepth?: number,
+  options?: StatsOptions) => ReferenceChain[];
+
+// 在工作线程中查询到GC根的最短引用链
+export const getShortestPathToGCRootAsync: (taskId: number, name: string, maxDepth?: number,
+  options?: StatsOptions) => Promise<ReferenceChain[]>;
+
+// 获取到GC根的最短引用链，结果为紧凑编码，用PackedNodeRefs解码
+export const getShortestPathToGCRootPacked: (taskId: number, name: string, maxDepth?: number,
+  options?: StatsOptions) => ArrayBuffer;
+
+// 获取节点的保留大小和直接支配者
+export const getRetainedInfo: (taskId: number, nodeId: NodeId) => RetainedInfo | undefined;
 
 // 二进制转成快照文件
-export const rawHeapTranslate: (filePath: string, outFilePath:string) => void;
+export const rawHeapTranslate: (filePath: string, outFilePath: string, options?: StatsOptions) => void;
+
+// 在工作线程中把二进制转成快照文件
+export const rawHeapTranslateAsync: (filePath: string, outFilePath: string,
+  options?: StatsOptions) => Promise<void>;
+
+/**
+ * 一个JSType或构造函数名下的对象统计
+ */
+export interface HeapSummaryEntry {
+  name: string;
+  /** 对象数 */
+  count: number;
+  /** self_size之和 */
+  selfSize: number;
+  /** native_size之和 */
+  nativeSize: number;
+  /** 抽样时各值95%置信区间的半宽 */
+  countError?: number;
+  selfSizeError?: number;
+  nativeSizeError?: number;
+}
+
+/**
+ * 指定hash的对象，抽样时也精确统计
+ */
+export interface HeapSummaryTarget {
+  hash: number;
+  nodeId: NodeId;
+  /** JSType名称 */
+  type: string;
+  /** 字符串表中的名称，没有时为空 */
+  name: string;
+  selfSize: number;
+  nativeSize: number;
+}
+
+/**
+ * rawheap的对象统计，各列表按selfSize从大到小排序；sampleRate小于1时各值为按抽样估算的结果
+ */
+export interface HeapSummary {
+  sampleRate: number;
+  /** 实际统计的对象数，包含targets */
+  sampledCount: number;
+  objectCount: number;
+  selfSize: number;
+  nativeSize: number;
+  /** 抽样时各总数95%置信区间的半宽 */
+  objectCountError?: number;
+  selfSizeError?: number;
+  nativeSizeError?: number;
+  /** 按JSType分组 */
+  types: HeapSummaryEntry[];
+  /** 按字符串表中的构造函数名分组，不含字符串对象 */
+  names: HeapSummaryEntry[];
+  targets: HeapSummaryTarget[];
+}
+
+export interface SummaryOptions {
+  /**
+   * 抽样比例(0, 1]，按对象ID选取，同一进程的多个dump抽到相同的对象；默认1，统计全部对象。
+   * V2格式读表时跳过未抽中的对象，V1格式要读出全部对象才能确定类型，抽样几乎不省时间
+   */
+  sampleRate?: number;
+  /** 总是精确统计并在targets中列出的对象 */
+  hashInfos?: HashInfo[];
+  /** 本次调用的分阶段统计，在JS线程中于Promise完成前回调一次 */
+  onStats?: (stats: AnalysisStats) => void;
+}
+
+// 在工作线程中统计rawheap各类型的对象数与大小，只读对象表和字符串表，不转换快照
+export const rawHeapSummary: (filePath: string, options?: SummaryOptions) => Promise<HeapSummary>;
 
 // 分析raw内存快照中指定对象的引用链
-export const rawAnalyzeHash: (filePath: string, hashInfos:HashInfo[]) => Promise<NodeRef[]>;
+export const rawAnalyzeHash: (filePath: string, hashInfos:HashInfo[], options?: AnalyzeOptions) => Promise<NodeRef[]>;
 
 // 分析内存快照中指定对象的引用链
-export const heapAnalyzeHash: (filePath: string, hashInfos:HashInfo[]) => Promise<NodeRef[]>;
+export const heapAnalyzeHash: (filePath: string, hashInfos:HashInfo[], options?: AnalyzeOptions) => Promise<NodeRef[]>;
+
+// 同rawAnalyzeHash，结果为紧凑编码的ArrayBuffer，用PackedNodeRefs按需解码
+export const rawAnalyzeHashPacked: (filePath: string, hashInfos:HashInfo[], options?: AnalyzeOptions) => Promise<ArrayBuffer>;
+
+// 同heapAnalyzeHash，结果为紧凑编码的ArrayBuffer，用PackedNodeRefs按需解码
+export const heapAnalyzeHashPacked: (filePath: string, hashInfos:HashInfo[], options?: AnalyzeOptions) => Promise<ArrayBuffer>;
+
+// 批量分析中的一个dump
+export interface DumpJob {
+  /** .rawheap或.heapsnapshot文件路径 */
+  filePath: string;
+  hashInfos: HashInfo[];
+}
+
+// 单个dump的分析结果
+export interface DumpResult {
+  filePath: string;
+  /** 该dump分析失败时的错误信息 */
+  error?: string;
+  refs: NodeRef[];
+  /** approximate分析rawheap时的对象统计 */
+  summary?: HeapSummary;
+}
+
+// 批量分析选项
+export interface BatchAnalyzeOptions {
+  /** 同时分析的dump预计内存之和的上限(字节)，不设置时为物理内存的1/4 */
+  memoryBudget?: number;
+  /** 引用链最大深度，默认10 */
+  maxDepth?: number;
+  /** 进度回调，phase为batch，nodes为已完成的dump数 */
+  onProgress?: (progress: AnalysisProgress) => void;
+  cancelToken?: CancelToken;
+  /** 每完成一个dump就在JS线程中回调一次 */
+  onDumpResult?: (result: DumpResult) => void;
+  /** .rawheap先扫描对象表，只转换和查询其中存在的目标 */
+  quickCheck?: boolean;
+  /**
+   * 近似分析：.rawheap不转换快照，只给出对象统计(summary)和各目标的精确大小，目标的ref为空且没有retainedSize；
+   * .heapsnapshot仍完整分析
+   */
+  approximate?: boolean;
+  /** approximate时的抽样比例，默认1，统计全部对象；抽样只在V2格式的rawheap上明显加快读取 */
+  sampleRate?: number;
+  /** 本次调用的分阶段统计，在JS线程中于Promise完成前回调一次 */
+  onStats?: (stats: AnalysisStats) => void;
+}
+
+// 在工作线程池中并行分析多个dump，结果与jobs一一对应，单个dump失败时只在其结果中给出error
+export const analyzeDumpBatch: (jobs: DumpJob[], options?: BatchAnalyzeOptions) => Promise<DumpResult[]>;
+
+/**
+ * 一个分组在两个dump之间的变化，大小为self_size + native_size
+ */
+export interface HeapDiffEntry {
+  /** 构造函数名，没有名称的对象按类型分组 */
+  name: string;
+  beforeCount: number;
+  beforeSize: number;
+  afterCount: number;
+  afterSize: number;
+  /** 只在after中出现的对象 */
+  addedCount: number;
+  addedSize: number;
+  /** 只在before中出现的对象 */
+  freedCount: number;
+  freedSize: number;
+  /** 两个dump中都存在的对象，按after中的分组统计，大小为after中的大小 */
+  survivingCount: number;
+  survivingSize: number;
+  countDelta: number;
+  sizeDelta: number;
+}
+
+/**
+ * 两个dump的对比结果，classes按sizeDelta的绝对值从大到小排序
+ */
+export interface HeapDiff {
+  before: string;
+  after: string;
+  total: HeapDiffEntry;
+  classes: HeapDiffEntry[];
+}
+
+export interface DiffOptions {
+  /** .heapsnapshot输入是否加载/写入sidecar索引 */
+  useIndex?: boolean;
+  cancelToken?: CancelToken;
+  /** 本次调用的分阶段统计，在JS线程中于Promise完成前回调一次 */
+  onStats?: (stats: AnalysisStats) => void;
+}
+
+// 在工作线程中按对象id比较同一进程先后的两个dump(.rawheap或.heapsnapshot)，rawheap不转换快照
+export const diffDumps: (before: string, after: string, options?: DiffOptions) => Promise<HeapDiff>;
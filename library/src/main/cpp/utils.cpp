@@ -91,8 +91,7 @@ bool EndsWith(const std::string &str, const std::string &suffix)
 
 bool IsLittleEndian()
 {
-    int i = 1;
-    return *reinterpret_cast<char *>(&i) == 1;
+    return HOST_LITTLE_ENDIAN;
 }
 
 uint16_t ByteToU16(char *data)
@@ -160,6 +159,7 @@ bool FileReader::Initialize(const std::string &path)
 
     file_.open(realPath, std::ios::binary);
     fileSize_= GetFileSize(realPath);
+    path_ = realPath;
     return true;
 }
 
@@ -243,6 +243,40 @@ uint32_t FileReader::GetFileSize(const std::string &path)
     return 0;
 }
 
+bool SequentialReader::Initialize(const std::string &path, uint32_t offset, uint32_t size, uint32_t bufferSize)
+{
+    if (!file_.Initialize(path) || !file_.Seek(offset)) {
+        return false;
+    }
+    buffer_.resize(std::min(size, bufferSize));
+    pos_ = 0;
+    end_ = 0;
+    remaining_ = size;
+    return true;
+}
+
+bool SequentialReader::Refill(uint32_t count)
+{
+    // move the unread tail to the front and fill the rest of the buffer
+    uint32_t tail = end_ - pos_;
+    if (tail > 0 && pos_ > 0 && memmove_s(buffer_.data(), buffer_.size(), buffer_.data() + pos_, tail) != EOK) {
+        LOG_ERROR_ << "memmove_s failed!";
+        return false;
+    }
+    pos_ = 0;
+    end_ = tail;
+    uint32_t readSize = std::min(static_cast<uint32_t>(buffer_.size()) - tail, remaining_);
+    if (readSize > 0) {
+        if (!file_.Read(buffer_.data() + tail, readSize)) {
+            remaining_ = 0;
+            return false;
+        }
+        end_ += readSize;
+        remaining_ -= readSize;
+    }
+    return end_ >= count;
+}
+
 bool Version::Parse(const std::string &version)
 {
     std::vector<int> result {};
@@ -16,10 +16,12 @@
 #ifndef RAWHEAP_TRANSLATE_UTILS_H
 #define RAWHEAP_TRANSLATE_UTILS_H
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <functional>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -44,8 +46,26 @@ bool GenerateDumpFileName(std::string &filename);
 
 bool EndsWith(const std::string &str, const std::string &suffix);
 
+// rawheap files are little-endian, the host byte order is known at compile time
+constexpr bool HOST_LITTLE_ENDIAN = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
 bool IsLittleEndian();
 
+// unaligned load of a little-endian u64, the byte swap is compiled out on little-endian hosts
+inline uint64_t LoadU64(const char *data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return HOST_LITTLE_ENDIAN ? value : __builtin_bswap64(value);
+}
+
+inline uint32_t LoadU32(const char *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return HOST_LITTLE_ENDIAN ? value : __builtin_bswap32(value);
+}
+
 uint16_t ByteToU16(char *data);
 
 uint32_t ByteToU32(char *data);
@@ -61,16 +81,11 @@ public:
     Logger(int level) : level_(level) {}
     ~Logger()
     {
-        switch (level_) {
-            case 1:
-                // 8: level width format
-                std::cout << std::left << std::setw(8) << "[ERROR] " << ss.str() << std::endl;
-                break;
-            default:
-                // 8: level width format
-                std::cout << std::left << std::setw(8) << "[INFO ] " << ss.str() << std::endl;
-                break;
-        }
+        // write the whole line unformatted: translations may log from several worker threads,
+        // and formatted output would modify the shared width/flags of std::cout
+        std::string line = (level_ == 1 ? "[ERROR] " : "[INFO ] ") + ss.str() + "\n";
+        std::cout.write(line.data(), line.size());
+        std::cout.flush();
     }
 
     template<typename T>
@@ -112,15 +127,73 @@ public:
         return fileSize_;
     }
 
+    const std::string &GetPath()
+    {
+        return path_;
+    }
+
     static uint32_t GetFileSize(const std::string &path);
 
 private:
     std::ifstream file_;
+    std::string path_;
     uint32_t left_ {0};
     uint32_t right_ {0};
     uint32_t fileSize_ {0};
 };
 
+// Reads the range [offset, offset + size) of a file front to back through a fixed-size buffer,
+// so memory stays bounded no matter how large the range is
+class SequentialReader {
+public:
+    static constexpr uint32_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+    SequentialReader() = default;
+    ~SequentialReader() = default;
+
+    bool Initialize(const std::string &path, uint32_t offset, uint32_t size,
+                    uint32_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    // make at least count bytes readable at Data(), false if fewer bytes are left in the range
+    bool Ensure(uint32_t count)
+    {
+        return end_ - pos_ >= count || Refill(count);
+    }
+
+    char *Data()
+    {
+        return buffer_.data() + pos_;
+    }
+
+    // bytes readable at Data(), after a failed Ensure these are all that is left
+    uint32_t Available() const
+    {
+        return end_ - pos_;
+    }
+
+    // skip bytes already made readable by Ensure
+    void Skip(uint32_t count)
+    {
+        pos_ += std::min(count, end_ - pos_);
+    }
+
+    // drop whatever is left in the buffer, reading stops at the end of the range
+    void SkipToEnd()
+    {
+        pos_ = end_;
+        remaining_ = 0;
+    }
+
+private:
+    bool Refill(uint32_t count);
+
+    FileReader file_;
+    std::vector<char> buffer_;
+    uint32_t pos_ {0};
+    uint32_t end_ {0};
+    uint32_t remaining_ {0};  // bytes of the range not read into the buffer yet
+};
+
 class Version {
 public:
     Version(int major, int minor, int build) : major_(major), minor_(minor), build_(build) {}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cstdio>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <string>
+#include <unistd.h>
+#include "worker_pool.h"
+
+namespace {
+// 最多创建的工作线程数，configure只能在这个范围内调整；实际还受核数限制，主机上的命令行工具可以用满多核
+const size_t MAX_WORKERS = 64;
+// 后台模式下工作线程的nice值
+const int BACKGROUND_NICE = 10;
+
+// 当前线程所属的工作线程下标，不是工作线程时为-1
+thread_local int currentWorker = -1;
+
+// 按cpufreq中的最高频率区分大小核，只返回最高频率最低的那一簇；三簇SoC的中核不算小核，无法区分时返回空
+std::vector<int> detectLittleCores(size_t cpuCount) {
+    std::vector<long> maxFreqs(cpuCount, 0);
+    long highest = 0;
+    long lowest = 0;
+    for (size_t cpu = 0; cpu < cpuCount; cpu++) {
+        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq";
+        FILE* fp = fopen(path.c_str(), "r");
+        if (fp == nullptr) {
+            return std::vector<int>();
+        }
+        if (fscanf(fp, "%ld", &maxFreqs[cpu]) != 1) {
+            maxFreqs[cpu] = 0;
+        }
+        fclose(fp);
+        highest = std::max(highest, maxFreqs[cpu]);
+        if (maxFreqs[cpu] > 0 && (lowest == 0 || maxFreqs[cpu] < lowest)) {
+            lowest = maxFreqs[cpu];
+        }
+    }
+    std::vector<int> little;
+    for (size_t cpu = 0; cpu < cpuCount; cpu++) {
+        if (lowest < highest && maxFreqs[cpu] == lowest) {
+            little.push_back(static_cast<int>(cpu));
+        }
+    }
+    return little;
+}
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.submit(*this, std::move(task));
+}
+
+void TaskGroup::wait() {
+    waitPending();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(error, firstError);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::waitPending() {
+    while (pending.load(std::memory_order_acquire) != 0) {
+        // 只帮忙执行本组的任务：其他组的任务可能很长(如整个dump的批量分析)，而且等待的线程(如libuv线程)
+        // 没有applyConfig设置的优先级和亲和性
+        if (pool.tryRunOne(currentWorker, this)) {
+            continue;
+        }
+        // 本组剩下的任务都在其他线程上执行，短暂等待后再尝试帮忙
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait_for(lock, std::chrono::milliseconds(1),
+                      [this]() { return pending.load(std::memory_order_acquire) == 0; });
+    }
+    // 最后一个任务在finish中持有锁直到通知完成，加锁一次确保它已退出后才能析构
+    std::lock_guard<std::mutex> lock(mutex);
+}
+
+void TaskGroup::finish(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error && !firstError) {
+        firstError = error;
+    }
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        done.notify_all();
+    }
+}
+
+WorkerPool& WorkerPool::instance() {
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::WorkerPool()
+    : queued(0), nextQueue(0), activeLimit(0), background(false), configGeneration(0), stopping(false) {
+    size_t cores = std::thread::hardware_concurrency();
+    if (cores == 0) {
+        cores = 4;
+    }
+    size_t workers = std::min(cores, MAX_WORKERS);
+    for (size_t i = 0; i < workers; i++) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    activeLimit = std::max<size_t>(1, std::min(cores - 1, workers));
+    littleCores = detectLittleCores(cores);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// 工作线程在第一次提交任务时才创建
+void WorkerPool::start() {
+    std::call_once(startFlag, [this]() {
+        for (size_t i = 0; i < queues.size(); i++) {
+            threads.emplace_back(&WorkerPool::workerLoop, this, static_cast<int>(i));
+        }
+    });
+}
+
+void WorkerPool::configure(size_t maxThreads, bool background_) {
+    size_t cores = std::thread::hardware_concurrency();
+    size_t limit = maxThreads == 0 ? (cores > 1 ? cores - 1 : 1) : maxThreads;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        activeLimit = std::max<size_t>(1, std::min(limit, queues.size()));
+        background = background_;
+        configGeneration++;
+    }
+    wake.notify_all();
+}
+
+size_t WorkerPool::threadCount() const {
+    return activeLimit.load(std::memory_order_relaxed);
+}
+
+void WorkerPool::submit(TaskGroup& group, std::function<void()> task) {
+    start();
+    // 工作线程提交的任务放在自己的队列尾部，其他线程的任务轮流分散到各个队列
+    size_t target = currentWorker >= 0 ? static_cast<size_t>(currentWorker) :
+                    nextQueue.fetch_add(1, std::memory_order_relaxed) % activeLimit.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->items.push_back({std::move(task), &group});
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    // 超出activeLimit的线程被唤醒后会继续等待，需要通知所有线程
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    wake.notify_all();
+}
+
+// 先从自己队列尾部取(最近提交的任务数据还在缓存中)，再从其他队列头部窃取
+bool WorkerPool::tryPop(int self, const TaskGroup* group, WorkItem& item) {
+    if (queued.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    if (self >= 0) {
+        WorkerQueue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (takeItem(own.items, group, true, item)) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    size_t count = queues.size();
+    size_t first = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+    for (size_t i = 0; i < count; i++) {
+        WorkerQueue& victim = *queues[(first + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (takeItem(victim.items, group, false, item)) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 取出队列中属于group的第一个任务，group为空时任何任务都匹配；backward为true时从尾部向前查找
+bool WorkerPool::takeItem(std::deque<WorkItem>& items, const TaskGroup* group, bool backward, WorkItem& item) {
+    if (items.empty()) {
+        return false;
+    }
+    if (group == nullptr) {
+        if (backward) {
+            item = std::move(items.back());
+            items.pop_back();
+        } else {
+            item = std::move(items.front());
+            items.pop_front();
+        }
+        return true;
+    }
+    size_t count = items.size();
+    for (size_t k = 0; k < count; k++) {
+        size_t pos = backward ? count - 1 - k : k;
+        if (items[pos].group == group) {
+            item = std::move(items[pos]);
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(pos));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::tryRunOne(int self, const TaskGroup* group) {
+    WorkItem item;
+    if (!tryPop(self, group, item)) {
+        return false;
+    }
+    execute(item);
+    return true;
+}
+
+void WorkerPool::execute(WorkItem& item) {
+    std::exception_ptr error;
+    try {
+        item.task();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    item.group->finish(error);
+}
+
+void WorkerPool::workerLoop(int index) {
+    currentWorker = index;
+    unsigned appliedGeneration = 0;
+    applyConfig(false);
+    while (true) {
+        unsigned generation = configGeneration.load(std::memory_order_acquire);
+        if (generation != appliedGeneration) {
+            appliedGeneration = generation;
+            applyConfig(background.load(std::memory_order_relaxed));
+        }
+        // 超出activeLimit的线程不主动取任务，只在限制放宽后恢复
+        bool active = static_cast<size_t>(index) < activeLimit.load(std::memory_order_relaxed);
+        if (active && tryRunOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this, index, appliedGeneration]() {
+            return stopping || configGeneration.load(std::memory_order_relaxed) != appliedGeneration ||
+                   (static_cast<size_t>(index) < activeLimit.load(std::memory_order_relaxed) &&
+                    queued.load(std::memory_order_relaxed) > 0);
+        });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+// 设置当前工作线程的优先级和CPU亲和性，失败时保持系统默认
+void WorkerPool::applyConfig(bool background_) {
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    setpriority(PRIO_PROCESS, tid, background_ ? BACKGROUND_NICE : 0);
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (background_ && !littleCores.empty()) {
+        for (int cpu : littleCores) {
+            CPU_SET(cpu, &mask);
+        }
+    } else {
+        size_t cores = std::thread::hardware_concurrency();
+        for (size_t cpu = 0; cpu < cores && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+    sched_setaffinity(0, sizeof(mask), &mask);
+}
+
+void WorkerPool::parallelFor(size_t begin, size_t end, size_t grain,
+                             const std::function<void(size_t, size_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(1, grain);
+    if (end - begin <= grain) {
+        fn(begin, end);
+        return;
+    }
+    TaskGroup group(*this);
+    for (size_t lo = begin; lo < end; lo += grain) {
+        size_t hi = std::min(end, lo + grain);
+        group.run([&fn, lo, hi]() { fn(lo, hi); });
+    }
+    group.wait();
+}
@@ -0,0 +1,99 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool;
+
+// 一组一起等待的任务，wait()期间调用线程只帮忙执行本组还在排队的任务，嵌套并行不会死锁，
+// 也不会在等待一个短任务时接手其他调用提交的长任务
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkerPool& pool_) : pool(pool_), pending(0) {}
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    // 析构时只等待任务结束，不再抛出异常
+    ~TaskGroup() { waitPending(); }
+
+    void run(std::function<void()> task);
+    // 等待所有任务完成，任务抛出的第一个异常在这里重新抛出
+    void wait();
+
+private:
+    friend class WorkerPool;
+    void waitPending();
+    void finish(std::exception_ptr error);
+
+    WorkerPool& pool;
+    std::atomic<size_t> pending;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr firstError;
+};
+
+// 进程内共享的工作线程池，转换和分析的并行任务都在这里执行
+// 每个工作线程有自己的任务队列，空闲时从其他线程的队列中窃取任务
+class WorkerPool {
+public:
+    static WorkerPool& instance();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool();
+
+    // maxThreads为0时按核数设置(核数-1，给UI线程留一个核)；
+    // background为true时工作线程降低优先级，并在大小核设备上只在小核上运行
+    void configure(size_t maxThreads, bool background);
+    // 当前参与执行任务的工作线程数，不包括等待结果的调用线程
+    size_t threadCount() const;
+
+    // 把[begin, end)按grain切块并行执行fn(lo, hi)，调用线程也参与执行，全部完成后返回
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    friend class TaskGroup;
+
+    struct WorkItem {
+        std::function<void()> task;
+        TaskGroup* group;
+    };
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<WorkItem> items;
+    };
+
+    WorkerPool();
+    void start();
+    void submit(TaskGroup& group, std::function<void()> task);
+    // group不为空时只取属于该组的任务
+    bool tryRunOne(int self, const TaskGroup* group = nullptr);
+    bool tryPop(int self, const TaskGroup* group, WorkItem& item);
+    void workerLoop(int index);
+    void applyConfig(bool background);
+    static bool takeItem(std::deque<WorkItem>& items, const TaskGroup* group, bool backward, WorkItem& item);
+    static void execute(WorkItem& item);
+
+    std::once_flag startFlag;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> nextQueue;
+    std::atomic<size_t> activeLimit;
+    std::atomic<bool> background;
+    std::atomic<unsigned> configGeneration;
+    std::vector<int> littleCores;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping;
+};
+
+#endif // WORKER_POOL_H
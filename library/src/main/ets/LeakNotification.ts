@@ -5,11 +5,9 @@ import { LEAK_START_URI, LEAK_TASK_ROUTE_NAME } from "./Constants"
 import { LeakGuard } from "./LeakGuard"
 import { appDatabase } from "./db/AppDatabase"
 import { analysisTaskTable } from "./db/DatabaseInterfaces"
-import { objWatch } from "./ObjWatch"
 import { fileIo } from "@kit.CoreFileKit"
-import { autoWatch } from "./AutoWatch"
 import { LeakInfo } from "./model/ObjInfo"
-import { sysWatch } from "./SysWatch"
+import { CheckTask } from "./model/CheckTask"
 
 export class LeakNotification {
   //单例
@@ -23,6 +21,9 @@ export class LeakNotification {
 
   private wantAgent:WantAgent = null
 
+  //批量分析积压的任务，由Index.ets注入
+  analyzeBatch: (tasks:CheckTask[])=>Promise<void>
+
   initPublisher(context:common.UIAbilityContext) {
     if (!notificationManager.isNotificationEnabledSync()) {//通知权限未开启
       return
@@ -55,35 +56,29 @@ export class LeakNotification {
   private readonly abilityLifecycleCallback: AbilityLifecycleCallback = {
     onAbilityCreate(ability: UIAbility) {
       appDatabase.analysisTaskDao.query((it)=>it.equalTo(analysisTaskTable.status ,1)).then((tasks)=>{
+        //积压的任务一起交给native批量分析，多个dump并行处理
+        const checkTasks:Promise<CheckTask | undefined>[] = []
         tasks.forEach((task)=>{
           if(!task.hashFile){//老数据不存在这个字段
             return
           }
           if(task.hashFile.endsWith('.hash')){//ObjWatch 的数据类型
-            fileIo.readText(task.hashFile).then((content)=>{
-              objWatch.analyzeHeapSnapshot({
-                task:task,
-                objInfos:JSON.parse(content)
-              })
-            })
-          }else if(task.heapSnapshotPath.endsWith('.rawheap')){//API20
-            fileIo.readText(task.hashFile).then((content)=>{
-              const leakInfo = JSON.parse(content) as LeakInfo
-              autoWatch.getDumpInfo({
-                task:task,
-                objInfos:leakInfo.leakObjList
-              })
-            })
-          }else{//SysWatch的数据缓存
-            fileIo.readText(task.hashFile).then((content)=>{
+            checkTasks.push(fileIo.readText(task.hashFile).then((content)=>{
+              const checkTask:CheckTask = { task:task, objInfos:JSON.parse(content) }
+              return checkTask
+            }).catch(()=>undefined))
+          }else{//API20的rawheap和SysWatch的数据缓存
+            checkTasks.push(fileIo.readText(task.hashFile).then((content)=>{
               const leakInfo = JSON.parse(content) as LeakInfo
-              sysWatch.analyzeHeapSnapshot({
-                task:task,
-                objInfos:leakInfo.leakObjList
-              })
-            })
+              const checkTask:CheckTask = { task:task, objInfos:leakInfo.leakObjList }
+              return checkTask
+            }).catch(()=>undefined))
           }
         })
+        return Promise.all(checkTasks)
+      }).then((checkTasks)=>{
+        //读取失败的任务保持待分析状态，下次启动再试
+        return LeakNotification.getInstance().analyzeBatch(checkTasks.filter((it)=>it != undefined) as CheckTask[])
       })
     },
     onWindowStageCreate(ability: UIAbility, windowStage: window.WindowStage) {
@@ -0,0 +1,13 @@
+import { fileIo } from "@kit.CoreFileKit"
+
+// 分析时在快照旁生成的sidecar索引
+export function snapshotIndexPath(heapSnapshotPath: string): string {
+  return heapSnapshotPath + '.idx'
+}
+
+// 删除快照文件及其sidecar索引，索引不存在时忽略
+export function unlinkSnapshot(heapSnapshotPath: string): Promise<void> {
+  return fileIo.unlink(heapSnapshotPath).finally(() => {
+    return fileIo.unlink(snapshotIndexPath(heapSnapshotPath)).catch(() => {})
+  })
+}
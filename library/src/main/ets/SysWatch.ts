@@ -3,9 +3,9 @@ import { HashSet, util } from "@kit.ArkTS"
 import { LeakGuard } from "./LeakGuard"
 import { ObjInfo } from "./model/ObjInfo"
 import { appDatabase } from "./db/AppDatabase"
-import { fileIo } from "@kit.CoreFileKit"
 import { AnalysisTask } from "./db/DatabaseInterfaces"
 import { CheckTask } from "./model/CheckTask"
+import { unlinkSnapshot } from "./SnapshotFiles"
 
 export class SysWatch {
   
@@ -41,7 +41,7 @@ export class SysWatch {
         }
         this.dumpHeapSnapshot().then((taskInfo)=>{
           return this.analyzeHeapSnapshot({ task:taskInfo, objInfos:leakInfos }).then(()=>{
-            return fileIo.unlink(taskInfo.heapSnapshotPath)
+            return unlinkSnapshot(taskInfo.heapSnapshotPath)
           })
         })
       },LeakGuard.getAnalyzeInterval())
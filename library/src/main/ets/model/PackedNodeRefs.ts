@@ -0,0 +1,141 @@
+import { util } from "@kit.ArkTS"
+import { NodeId, NodeRef, ReferenceChain, ReferenceChainNode } from "libleakguard.so"
+
+const MAGIC = 0x5250474C
+const VERSION = 1
+const NODE_SIZE = 24
+const TARGET_SIZE = 32
+const LINK_SIZE = 12
+// 节点ID高32位不小于该值时超出Number安全整数范围
+const SAFE_ID_HIGH_LIMIT = 0x200000
+const UINT32_RANGE = 0x100000000
+
+/**
+ * heapAnalyzeHashPacked/rawAnalyzeHashPacked/getShortestPathToGCRootPacked返回的紧凑编码结果，
+ * 以及onPackedResult逐个推送的单目标片段
+ * 字符串和引用链节点只在访问时解码，布局见native侧packed_result.h
+ */
+export class PackedNodeRefs {
+  private view: DataView
+  private bytes: Uint8Array
+  private decoder: util.TextDecoder = util.TextDecoder.create('utf-8')
+  private strings: Array<string | undefined>
+  private nodes: Array<ReferenceChainNode | undefined>
+  private targetCount: number
+  private stringOffsetsOffset: number
+  private nodesOffset: number
+  private targetsOffset: number
+  private linksOffset: number
+  private stringDataOffset: number
+
+  constructor(buffer: ArrayBuffer) {
+    this.view = new DataView(buffer)
+    this.bytes = new Uint8Array(buffer)
+    if (buffer.byteLength < 48 || this.u32(0) != MAGIC || this.u32(4) != VERSION) {
+      throw new Error('invalid packed node refs')
+    }
+    this.strings = new Array<string | undefined>(this.u32(8))
+    this.nodes = new Array<ReferenceChainNode | undefined>(this.u32(12))
+    this.targetCount = this.u32(16)
+    this.stringOffsetsOffset = this.u32(24)
+    this.nodesOffset = this.u32(28)
+    this.targetsOffset = this.u32(32)
+    this.linksOffset = this.u32(36)
+    this.stringDataOffset = this.u32(40)
+  }
+
+  get length(): number {
+    return this.targetCount
+  }
+
+  hash(index: number): number {
+    return this.view.getInt32(this.targetsOffset + index * TARGET_SIZE, true)
+  }
+
+  name(index: number): string {
+    return this.string(this.u32(this.targetsOffset + index * TARGET_SIZE + 4))
+  }
+
+  selfSize(index: number): number {
+    return this.view.getFloat64(this.targetsOffset + index * TARGET_SIZE + 16, true)
+  }
+
+  retainedSize(index: number): number {
+    return this.view.getFloat64(this.targetsOffset + index * TARGET_SIZE + 24, true)
+  }
+
+  ref(index: number): ReferenceChain[] {
+    const targetOffset = this.targetsOffset + index * TARGET_SIZE
+    const firstLink = this.u32(targetOffset + 8)
+    const linkCount = this.u32(targetOffset + 12)
+    const chains: ReferenceChain[] = []
+    for (let i = firstLink; i < firstLink + linkCount; i++) {
+      const linkOffset = this.linksOffset + i * LINK_SIZE
+      chains.push({
+        from: this.node(this.u32(linkOffset)),
+        edgeType: this.string(this.u32(linkOffset + 8)),
+        to: this.node(this.u32(linkOffset + 4))
+      })
+    }
+    return chains
+  }
+
+  nodeRef(index: number): NodeRef {
+    return {
+      hash: this.hash(index),
+      name: this.name(index),
+      ref: this.ref(index),
+      selfSize: this.selfSize(index),
+      retainedSize: this.retainedSize(index)
+    }
+  }
+
+  // 全部解码，用于持久化等需要完整对象的场景
+  toNodeRefs(): NodeRef[] {
+    const nodeRefs: NodeRef[] = []
+    for (let i = 0; i < this.targetCount; i++) {
+      nodeRefs.push(this.nodeRef(i))
+    }
+    return nodeRefs
+  }
+
+  private u32(offset: number): number {
+    return this.view.getUint32(offset, true)
+  }
+
+  private string(id: number): string {
+    let str = this.strings[id]
+    if (str === undefined) {
+      const start = this.u32(this.stringOffsetsOffset + id * 4)
+      const end = this.u32(this.stringOffsetsOffset + (id + 1) * 4)
+      str = this.decoder.decodeToString(this.bytes.subarray(this.stringDataOffset + start, this.stringDataOffset + end))
+      this.strings[id] = str
+    }
+    return str
+  }
+
+  private nodeId(offset: number): NodeId {
+    const low = this.u32(offset)
+    const high = this.u32(offset + 4)
+    if (high < SAFE_ID_HIGH_LIMIT) {
+      return high * UINT32_RANGE + low
+    }
+    return BigInt(high) * BigInt(UINT32_RANGE) + BigInt(low)
+  }
+
+  private node(index: number): ReferenceChainNode {
+    let node = this.nodes[index]
+    if (node === undefined) {
+      const offset = this.nodesOffset + index * NODE_SIZE
+      node = {
+        nodeId: this.nodeId(offset),
+        name: this.string(this.u32(offset + 8)),
+        type: this.string(this.u32(offset + 12)),
+        path: this.string(this.u32(offset + 16)),
+        line: this.view.getInt32(offset + 20, true)
+      }
+      this.nodes[index] = node
+    }
+    return node
+  }
+}